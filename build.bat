@@ -84,12 +84,16 @@ g++ -c client/halo_data/chat.cpp -masm=intel -o bin/client__halo_data__chat.o
 g++ -c client/halo_data/global.cpp %ARGS% -o bin/client__halo_data__global.o
 g++ -c client/halo_data/keyboard.cpp %ARGS% -o bin/client__halo_data__keyboard.o
 g++ -c client/halo_data/map.cpp %ARGS% -o bin/client__halo_data__map.o
+g++ -c client/halo_data/object_changes.cpp %ARGS% -o bin/client__halo_data__object_changes.o
+g++ -c client/halo_data/object_grid.cpp %ARGS% -o bin/client__halo_data__object_grid.o
 g++ -c client/halo_data/resolution.cpp -masm=intel -o bin/client__halo_data__resolution.o
 g++ -c client/halo_data/server.cpp %ARGS% -o bin/client__halo_data__server.o
 g++ -c client/halo_data/spawn_object.cpp -masm=intel -o bin/client__halo_data__spawn_object.o
 g++ -c client/halo_data/script.cpp -masm=intel -o bin/client__halo_data__script.o
 g++ -c client/halo_data/table.cpp %ARGS% -o bin/client__halo_data__table.o
+g++ -c client/halo_data/table_view.cpp %ARGS% -o bin/client__halo_data__table_view.o
 g++ -c client/halo_data/tag_data.cpp %ARGS% -o bin/client__halo_data__tag_data.o
+g++ -c client/halo_data/tag_dependencies.cpp %ARGS% -o bin/client__halo_data__tag_dependencies.o
 g++ -c client/halo_data/tiarace/hce_tag_class_int.cpp %ARGS% -o bin/client__halo_data__tiarace__hce_tag_class_int.o
 
 g++ -c client/hooks/camera.cpp %ARGS% -o bin/client__hooks__camera.o
@@ -108,6 +112,7 @@ g++ -c client/interpolation/particle.cpp %ARGSFAST% -o bin/client__interpolation
 g++ -c client/interpolation/widget.cpp %ARGS% -o bin/client__interpolation__widget.o
 
 g++ -c client/lua/lua.cpp %ARGS% -o bin/client__lua__lua.o
+g++ -c client/lua/lua_cache.cpp %ARGS% -o bin/client__lua__lua_cache.o
 g++ -c client/lua/lua_callback.cpp %ARGS% -o bin/client__lua__lua_callback.o
 g++ -c client/lua/lua_game.cpp %ARGS% -o bin/client__lua__lua_game.o
 g++ -c client/lua/lua_io.cpp %ARGS% -o bin/client__lua__lua_io.o
@@ -116,6 +121,10 @@ g++ -c client/messaging/messaging.cpp -masm=intel -o bin/client__messaging__mess
 
 gcc -c client/startup/crc32.c %ARGS% -o bin/client__startup__crc32.o
 g++ -c client/startup/fast_startup.cpp %ARGS% -o bin/client__startup__fast_startup.o
+g++ -c client/startup/map_file.cpp %ARGS% -o bin/client__startup__map_file.o
+g++ -c client/startup/map_prefetch.cpp %ARGS% -o bin/client__startup__map_prefetch.o
+g++ -c client/startup/map_prefetch_plan.cpp %ARGS% -o bin/client__startup__map_prefetch_plan.o
+g++ -c client/startup/read_ahead.cpp %ARGS% -o bin/client__startup__read_ahead.o
 
 g++ -c client/visuals/anisotropic_filtering.cpp %ARGS% -o bin/client__visuals__af.o
 g++ -c client/visuals/gametype_indicator.cpp %ARGS% -o bin/client__visuals__gametype_indicator.o
@@ -131,7 +140,15 @@ g++ -c client/xbox/split_screen_hud.cpp %ARGS% -o bin/client__xbox__split_screen
 g++ -c code_injection/hacclient/codefinder.cpp %ARGS% -o bin/code_injection__hacclient__codefinder.o
 g++ -c code_injection/signature.cpp %ARGS% -o bin/code_injection__signature.o
 
+g++ -c map/tag_data_reader.cpp %ARGS% -o bin/map__tag_data_reader.o
+g++ -c map/tag_data_view.cpp %ARGS% -o bin/map__tag_data_view.o
+
+g++ -c math/batch.cpp %ARGSFAST% -o bin/math__batch.o
+g++ -c math/batch_sse2.cpp %ARGSFAST% -msse2 -o bin/math__batch_sse2.o
+g++ -c math/batch_avx2.cpp %ARGSFAST% -mavx2 -mfma -o bin/math__batch_avx2.o
 g++ -c math/data_types.cpp %ARGSFAST% -o bin/math__data_types.o
+g++ -c math/quantize.cpp %ARGSFAST% -o bin/math__quantize.o
+g++ -c math/spatial_grid.cpp %ARGSFAST% -o bin/math__spatial_grid.o
 
 :END
 g++ bin/* %LARGS% -L client/lua/lua/bin -llua -shared -lws2_32 -static-libgcc -static-libstdc++ -static -luserenv -static -lpthread -static -ladvapi32 -o "bin/chimera.dll"
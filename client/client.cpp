@@ -43,6 +43,8 @@
 #include "halo_data/chat.h"
 #include "halo_data/keyboard.h"
 #include "halo_data/map.h"
+#include "halo_data/object_changes.h"
+#include "halo_data/object_grid.h"
 #include "halo_data/resolution.h"
 
 #include "hooks/camera.h"
@@ -58,6 +60,7 @@
 #include "messaging/messaging.h"
 
 #include "startup/fast_startup.h"
+#include "startup/map_prefetch.h"
 
 #include "visuals/anisotropic_filtering.h"
 #include "visuals/letterbox.h"
@@ -115,6 +118,8 @@ static void init() {
 
     save_all_changes();
     setup_lua();
+
+    if(find_fast_startup_sigs()) start_map_prehashing();
 }
 
 void initialize_client() noexcept {
@@ -131,6 +136,8 @@ void initialize_client() noexcept {
     }
     initialize_console();
     initialize_rcon_message();
+    setup_object_changes();
+    setup_object_grid();
     add_tick_event(init);
     add_tick_event(camo_fix);
     dart_fix();
@@ -468,7 +475,10 @@ void initialize_client() noexcept {
         "  - chimera_modded_stock_maps [true/false]"
     , 0, 1, find_fast_startup_sigs(), true);
 
-    if(find_fast_startup_sigs()) setup_fast_startup();
+    if(find_fast_startup_sigs()) {
+        setup_fast_startup();
+        setup_map_prefetch();
+    }
 
     if(custom_keystone_in_use()) {
         if(find_pc_map_compat_sigs()) setup_pc_map_compatibility();
@@ -113,38 +113,32 @@ static void show_spawns() noexcept {
 
 		unsigned int marker = 0xFFFFFFFF;
 
-		auto *&tags = *reinterpret_cast<HaloTag **>(0x40440000);
-		for (size_t i = 0; i < *reinterpret_cast<uint32_t *>(0x4044000C); i++) {
-			auto &tag = tags[i];
-			if (tag.tag_class == 0x7363656E && strcmp(tag.path, "scenery\\overflow_spawn_marker\\overflow_spawn_marker") == 0) {
-				marker = tag.id;
-				biped = false;
-				break;
-			}
+		auto *marker_tag = HaloTag::lookup(0x7363656E, "scenery\\overflow_spawn_marker\\overflow_spawn_marker");
+		if (marker_tag) {
+			marker = marker_tag->id;
+			biped = false;
 		}
 
 		if (marker == 0xFFFFFFFF) {
 			biped = true;
-			for (size_t i = 0; i < *reinterpret_cast<uint32_t *>(0x4044000C); i++) {
-				auto &tag = tags[i];
-				if (tag.tag_class == 0x6D617467 && strcmp(tag.path, "globals\\globals") == 0) {
-					auto &player_info_count = *reinterpret_cast<uint32_t *>(tag.data + 0x170);
-					auto *&player_info = *reinterpret_cast<char **>(tag.data + 0x174);
-					if (player_info_count) {
-						marker = *reinterpret_cast<HaloTagID *>(player_info + 0xC);
-						auto &mpinfo_count = *reinterpret_cast<uint32_t *>(tag.data + 0x164);
-						auto *&mpinfo = *reinterpret_cast<char **>(tag.data + 0x168);
-						if (mpinfo_count) {
-							if (marker == *reinterpret_cast<uint32_t *>(mpinfo + 0x10 + 0xC)) {
-								tickles = ticks;
-								return;
-							}
-						} else {
+			auto *globals_tag = HaloTag::lookup(0x6D617467, "globals\\globals");
+			if (globals_tag) {
+				auto &tag = *globals_tag;
+				auto &player_info_count = *reinterpret_cast<uint32_t *>(tag.data + 0x170);
+				auto *&player_info = *reinterpret_cast<char **>(tag.data + 0x174);
+				if (player_info_count) {
+					marker = *reinterpret_cast<HaloTagID *>(player_info + 0xC);
+					auto &mpinfo_count = *reinterpret_cast<uint32_t *>(tag.data + 0x164);
+					auto *&mpinfo = *reinterpret_cast<char **>(tag.data + 0x168);
+					if (mpinfo_count) {
+						if (marker == *reinterpret_cast<uint32_t *>(mpinfo + 0x10 + 0xC)) {
 							tickles = ticks;
 							return;
 						}
+					} else {
+						tickles = ticks;
+						return;
 					}
-					break;
 				}
 			}
 
@@ -235,7 +229,9 @@ static void show_spawns() noexcept {
 
 		std::vector<NoSpawnSphere> nope;
 
-		for (size_t i = 0; i < 2048; i++) {
+		TableView<char> object_table(get_object_table());
+		for (auto object = object_table.begin(); object != object_table.end(); ++object) {
+			size_t i = object.index();
 			bool skip = false;
 			for (size_t s = 0; s < total_spawns; s++) {
 				if ((objects[s].object_id & 0xFFFF) == i) {
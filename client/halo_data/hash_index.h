@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/// Starting value of an FNV-1a hash
+#define FNV1A_OFFSET_BASIS 0x811C9DC5
+
+/// Marks an empty slot in a HashIndex
+#define HASH_INDEX_EMPTY 0xFFFFFFFF
+
+/// Mix one character (or other small value) into an FNV-1a hash.
+static inline uint32_t fnv1a(uint32_t hash, uint32_t value) noexcept {
+    return (hash ^ value) * 0x01000193;
+}
+
+/// This is an open addressing hash table of values, such as indices into one of Halo's tables, keyed on a hash of
+/// whatever they're looked up by. Different keys can have the same hash, so anything found should be checked.
+class HashIndex {
+public:
+    /// Remove every value and make room for count values. The table is kept at most half full so probes stay short.
+    void reset(size_t count) noexcept {
+        size_t slot_count = 16;
+        while(slot_count < count * 2) slot_count <<= 1;
+        this->slots.assign(slot_count, Slot { 0, HASH_INDEX_EMPTY });
+    }
+
+    /// Return true if reset() hasn't been called yet.
+    bool empty() const noexcept {
+        return this->slots.empty();
+    }
+
+    /// Add a value. There must be room for it, and it can't be HASH_INDEX_EMPTY.
+    void insert(uint32_t hash, uint32_t value) noexcept {
+        size_t mask = this->slots.size() - 1;
+        size_t slot = hash & mask;
+        while(this->slots[slot].value != HASH_INDEX_EMPTY) slot = (slot + 1) & mask;
+        this->slots[slot] = Slot { hash, value };
+    }
+
+    /// Call found for each value added with hash until it returns true.
+    template<typename F>
+    void find(uint32_t hash, F found) const noexcept {
+        if(this->slots.empty()) return;
+        size_t mask = this->slots.size() - 1;
+        for(size_t slot = hash & mask; this->slots[slot].value != HASH_INDEX_EMPTY; slot = (slot + 1) & mask) {
+            if(this->slots[slot].hash == hash && found(this->slots[slot].value)) return;
+        }
+    }
+
+private:
+    struct Slot {
+        uint32_t hash;
+        uint32_t value;
+    };
+    std::vector<Slot> slots;
+};
@@ -1,8 +1,11 @@
 #include "map.h"
 
+#include <unordered_map>
+#include <vector>
 #include <Windows.h>
 #include "../client_signature.h"
 #include "tag_data.h"
+#include "../../map/tag_data_view.h"
 #include "../hooks/tick.h"
 #include "../messaging/messaging.h"
 
@@ -24,39 +27,98 @@ uint32_t maps_count() noexcept {
     return *map_count;
 }
 
+// Resource offsets in retail maps that need boffset/soffset added to them. Tag data is always loaded at the same address,
+// so these can be kept as pointers and reused whenever a map with the same CRC is loaded again.
+struct ResourcePatches {
+    std::vector<uint32_t *> bitmaps;
+    std::vector<uint32_t *> sounds;
+
+    /// Size of the tag data the patches were found in
+    uint32_t tag_data_size;
+};
+
+static std::unordered_map<uint32_t, ResourcePatches> resource_patches;
+
+static bool add_resource_patch(const MapResource &resource, void *user) noexcept {
+    if(resource.external) {
+        auto &patches = *reinterpret_cast<ResourcePatches *>(user);
+        (resource.type == MAP_RESOURCE_BITMAP ? patches.bitmaps : patches.sounds).push_back(reinterpret_cast<uint32_t *>(resource.offset_address));
+    }
+    return true;
+}
+
+static void find_resource_patches(ResourcePatches &patches) noexcept {
+    patches.tag_data_size = get_map_header().tag_data_size;
+    TagDataView tag_data(reinterpret_cast<const void *>(MAP_TAG_DATA_ADDRESS), patches.tag_data_size);
+    tag_data.for_each_resource(add_resource_patch, &patches);
+}
+
+// Get the CRC32 of the map being loaded, or 0xFFFFFFFF if it isn't known yet. This has to go by the file Halo is
+// loading. The name in the header doesn't have to match it, so it could be the name of a different map.
+static uint32_t loaded_map_crc32() noexcept {
+    if(!find_fast_startup_sigs()) return 0xFFFFFFFF;
+    static char *loading_map = *reinterpret_cast<char **>(get_signature("loading_map_sig").address() + 1);
+    auto *indices = map_indices();
+    uint32_t crc = 0xFFFFFFFF;
+    size_t matches = 0;
+    for(size_t i=0;i<maps_count();i++) {
+        if(_stricmp(indices[i].file_name, loading_map) == 0) {
+            crc = indices[i].crc32;
+            matches++;
+        }
+    }
+    return matches == 1 ? crc : 0xFFFFFFFF;
+}
+
 static void on_load() noexcept {
     if(get_map_header().engine_type == 7) {
-        HaloTag *tags = *reinterpret_cast<HaloTag **>(0x40440000);
-        for(size_t i=0;i<*reinterpret_cast<uint32_t *>(0x4044000C);i++) {
-            if(tags[i].tag_class == 0x6269746D) {
-                auto *bitmaps = *reinterpret_cast<char **>(tags[i].data + 0x60 + 4);
-                for(uint32_t b=0;b<*reinterpret_cast<uint32_t *>(tags[i].data + 0x60);b++) {
-                    auto *bitmap = bitmaps + b * 0x30;
-                    if((bitmap[0xF] & 1) == 0) continue;
-                    *reinterpret_cast<uint32_t *>(bitmap + 0x18) += boffset;
-                }
+        // Maps without a known CRC can't be told apart from an edited copy, so their patches are found every time.
+        ResourcePatches uncached;
+        auto *patches = &uncached;
+        uint32_t crc = loaded_map_crc32();
+        if(crc != 0xFFFFFFFF) {
+            // A cached list that doesn't fit this map's tag data can't be trusted, so don't touch it.
+            auto found = resource_patches.find(crc);
+            if(found != resource_patches.end()) {
+                if(found->second.tag_data_size == get_map_header().tag_data_size) patches = &found->second;
+                else find_resource_patches(uncached);
             }
-            else if(tags[i].tag_class == 0x736E6421) {
-                auto *pitch_ranges = *reinterpret_cast<char **>(tags[i].data + 0x98 + 4);
-                for(uint32_t r=0;r<*reinterpret_cast<uint32_t *>(tags[i].data + 0x98);r++) {
-                    auto *range = pitch_ranges + r * 0x48;
-                    auto *permutations = *reinterpret_cast<char **>(range + 0x3C + 4);
-                    for(uint32_t p=0;p<*reinterpret_cast<uint32_t *>(range + 0x3C);p++) {
-                        auto *permutation = permutations + p * 0x7C;
-                        if((permutation[0x44] & 1) == 0) continue;
-                        *reinterpret_cast<uint32_t *>(permutation + 0x48) += soffset;
-                    }
-                }
+            else {
+                patches = &resource_patches[crc];
+                find_resource_patches(*patches);
             }
         }
+        else {
+            find_resource_patches(uncached);
+        }
+
+        for(auto *offset : patches->bitmaps) {
+            *offset += boffset;
+        }
+        for(auto *offset : patches->sounds) {
+            *offset += soffset;
+        }
     }
 }
 
 const char *bitmaps_path = "chimera\\c_bitmaps";
 const char *sounds_path = "chimera\\c_sounds";
 
+// Size of the buffer used to append the PC resource map
+#define RESOURCE_COPY_CHUNK_SIZE (4 * 1024 * 1024)
+
+// Append the rest of a file to another, a chunk at a time.
+static bool append_file(FILE *from, FILE *to) noexcept {
+    std::vector<char> buffer(RESOURCE_COPY_CHUNK_SIZE);
+    size_t read;
+    while((read = fread(buffer.data(), 1, buffer.size(), from)) != 0) {
+        if(fwrite(buffer.data(), read, 1, to) != 1) return false;
+    }
+    return !ferror(from);
+}
+
 uint32_t open_or_create(const char *chimera_path, const char *pc_path, const char *ce_path, bool create_if_not_exists) {
-    FILE *b = fopen(chimera_path, "r");
+    FILE *b = fopen(chimera_path, "rb");
     if(b) {
         fseek(b, -4, SEEK_END);
         uint32_t offset;
@@ -65,35 +127,33 @@ uint32_t open_or_create(const char *chimera_path, const char *pc_path, const cha
         return offset;
     }
     else if(create_if_not_exists) {
-        FILE *sce = fopen(ce_path, "rb");
-        if(sce) {
-            FILE *spc = fopen(pc_path, "rb");
-            if(spc) {
-                FILE *sch = fopen(chimera_path, "wb");
-                if(sch) {
-                    fseek(sce, 0, SEEK_END);
-                    fseek(spc, 0, SEEK_END);
-                    size_t sce_size = ftell(sce);
-                    size_t spc_size = ftell(spc);
-                    fseek(sce, 0, SEEK_SET);
-                    fseek(spc, 0, SEEK_SET);
-                    size_t buff_size = sce_size + spc_size + sizeof(uint32_t);
-                    char *buffer = new char[buff_size];
-                    fread(buffer, sce_size, 1, sce);
-                    fread(buffer + sce_size, spc_size, 1, spc);
-                    *reinterpret_cast<uint32_t *>(buffer + sce_size + spc_size) = sce_size;
-                    fwrite(buffer, buff_size, 1, sch);
-                    delete[] buffer;
-                    fclose(sce);
-                    fclose(spc);
-                    fclose(sch);
-                    DeleteFile(pc_path);
-                    return sce_size;
-                }
-                fclose(spc);
+        WIN32_FILE_ATTRIBUTE_DATA ce_attributes;
+        if(!GetFileAttributesExA(ce_path, GetFileExInfoStandard, &ce_attributes) || ce_attributes.nFileSizeHigh != 0) return 0;
+        uint32_t sce_size = ce_attributes.nFileSizeLow;
+
+        FILE *spc = fopen(pc_path, "rb");
+        if(!spc) return 0;
+
+        // The Custom Edition map is copied by the OS, then the PC map is streamed onto the end of it followed by the
+        // offset of the PC map. This is all done on a temporary file so an interrupted copy is never mistaken for a
+        // finished one.
+        char temp_path[MAX_PATH] = {};
+        snprintf(temp_path, sizeof(temp_path), "%s.tmp", chimera_path);
+        bool created = false;
+        if(CopyFileExA(ce_path, temp_path, nullptr, nullptr, nullptr, 0)) {
+            FILE *sch = fopen(temp_path, "ab");
+            if(sch) {
+                created = append_file(spc, sch) && fwrite(&sce_size, sizeof(sce_size), 1, sch) == 1;
+                created = fclose(sch) == 0 && created;
             }
-            fclose(sce);
         }
+        fclose(spc);
+
+        if(created && MoveFileExA(temp_path, chimera_path, MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFile(pc_path);
+            return sce_size;
+        }
+        DeleteFile(temp_path);
     }
     return 0;
 }
@@ -0,0 +1,94 @@
+#include "object_changes.h"
+#include "table.h"
+#include "../hooks/map_load.h"
+#include "../hooks/tick.h"
+
+// What each slot in the object table held as of the last tick
+struct ObjectSnapshot {
+    uint32_t id;
+    uint32_t tag_id;
+    Vector3D position;
+};
+
+static std::vector<ObjectSnapshot> snapshots;
+
+// Indices of the objects that existed as of the last tick
+static std::vector<uint32_t> live_indices;
+static std::vector<uint32_t> previous_live_indices;
+
+static ObjectChanges changes;
+
+bool ObjectChanges::was_moved(size_t index) const noexcept {
+    if(index / 32 >= this->moved.size()) return false;
+    return (this->moved[index / 32] >> (index % 32)) & 1;
+}
+
+const ObjectChanges &object_changes() noexcept {
+    return changes;
+}
+
+uint32_t object_changes_id(size_t index) noexcept {
+    return index < snapshots.size() ? snapshots[index].id : NULL_ID;
+}
+
+static void update_object_changes() noexcept {
+    TableView<char> objects(get_object_table());
+    if(snapshots.size() != objects.max_count()) {
+        snapshots.assign(objects.max_count(), ObjectSnapshot { NULL_ID, NULL_ID, Vector3D() });
+        previous_live_indices.clear();
+    }
+
+    changes.tick = tick_count();
+    changes.spawned.clear();
+    changes.deleted.clear();
+    changes.tag_changed.clear();
+    changes.moved.assign((snapshots.size() + 31) / 32, 0);
+
+    live_indices.clear();
+    for(auto entry = objects.begin(); entry != objects.end(); ++entry) {
+        auto index = static_cast<uint32_t>(entry.index());
+        uint32_t id = (static_cast<uint32_t>(*reinterpret_cast<uint16_t *>(&*entry)) << 16) | index;
+        auto *data = *reinterpret_cast<BaseHaloObject **>(&*entry + 0x8);
+        auto &snapshot = snapshots[index];
+
+        if(snapshot.id != id) {
+            if(snapshot.id != NULL_ID) changes.deleted.push_back(snapshot.id);
+            changes.spawned.push_back(id);
+        }
+        else {
+            if(snapshot.tag_id != data->tag_id.id) changes.tag_changed.push_back(id);
+            if(snapshot.position.x != data->position.x || snapshot.position.y != data->position.y || snapshot.position.z != data->position.z) {
+                changes.moved[index / 32] |= 1u << (index % 32);
+            }
+        }
+
+        snapshot.id = id;
+        snapshot.tag_id = data->tag_id.id;
+        snapshot.position = data->position;
+        live_indices.push_back(index);
+    }
+
+    // Slots that were reused were handled above, so anything that's free now was deleted.
+    for(auto index : previous_live_indices) {
+        auto &snapshot = snapshots[index];
+        if(snapshot.id != NULL_ID && !objects.get(index)) {
+            changes.deleted.push_back(snapshot.id);
+            snapshot.id = NULL_ID;
+        }
+    }
+    live_indices.swap(previous_live_indices);
+}
+
+// Objects from the last map are gone, and nothing on the new map is a continuation of them, so start over rather than
+// report them as deleted or compare new objects against them.
+static void reset_object_changes() noexcept {
+    snapshots.clear();
+    live_indices.clear();
+    previous_live_indices.clear();
+    changes = ObjectChanges();
+}
+
+void setup_object_changes() noexcept {
+    add_tick_event(update_object_changes, EVENT_PRIORITY_BEFORE);
+    add_map_load_event(reset_object_changes, EVENT_PRIORITY_BEFORE);
+}
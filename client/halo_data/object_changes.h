@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/// Objects that changed during the last tick. Object IDs include the salt, so an ID is never confused with a later
+/// object in the same slot.
+struct ObjectChanges {
+    /// Tick the changes were found on
+    int32_t tick = -1;
+
+    /// Objects that were created
+    std::vector<uint32_t> spawned;
+
+    /// Objects that were deleted, including objects replaced by another object in the same slot
+    std::vector<uint32_t> deleted;
+
+    /// Objects that existed on both ticks but now have a different tag
+    std::vector<uint32_t> tag_changed;
+
+    /// Bit i % 32 of moved[i / 32] is set if the object at index i existed on both ticks and changed position
+    std::vector<uint32_t> moved;
+
+    /// Return true if the object at index moved.
+    bool was_moved(size_t index) const noexcept;
+};
+
+/// Get the changes found on the last tick. The object table is compared against the previous tick once, before any other
+/// tick events run, so this can be used instead of scanning the object table. When a map is loaded, this starts over, so
+/// every object on the new map's first tick is reported as spawned and nothing from the old map is reported as deleted.
+const ObjectChanges &object_changes() noexcept;
+
+/// Get the full ID of the object at index as of the last tick, or 0xFFFFFFFF if there isn't one.
+uint32_t object_changes_id(size_t index) noexcept;
+
+/// Start keeping track of object changes.
+void setup_object_changes() noexcept;
@@ -0,0 +1,65 @@
+#include "object_changes.h"
+#include "object_grid.h"
+#include "table.h"
+#include "../hooks/map_load.h"
+#include "../hooks/tick.h"
+#include "../../math/spatial_grid.h"
+
+// Objects are keyed by their index in the object table and kept up to date from the object change journal, so only
+// objects that were created, deleted or moved are touched each tick.
+static SpatialGrid object_grid;
+
+static void insert_object(uint32_t index) noexcept {
+    auto *data = reinterpret_cast<BaseHaloObject *>(HaloObject(index).object_data());
+    if(data) object_grid.insert(index, data->position);
+    else object_grid.remove(index);
+}
+
+static void update_object_grid() noexcept {
+    auto &changes = object_changes();
+
+    // A slot can be both deleted and spawned in the same tick, so deletions go first.
+    for(auto id : changes.deleted) {
+        object_grid.remove(id & 0xFFFF);
+    }
+    for(auto id : changes.spawned) {
+        insert_object(id & 0xFFFF);
+    }
+    for(size_t w=0;w<changes.moved.size();w++) {
+        for(uint32_t mask = changes.moved[w]; mask; mask &= mask - 1) {
+            uint32_t bit = 0;
+            while(!((mask >> bit) & 1)) bit++;
+            insert_object(w * 32 + bit);
+        }
+    }
+}
+
+// The change journal starts over when a map loads without reporting the old map's objects as deleted, so drop them here.
+static void clear_object_grid() noexcept {
+    object_grid.clear();
+}
+
+// Turn object indices from the grid into object IDs, dropping any that no longer exist.
+static void append_object_ids(const std::vector<uint32_t> &indices, std::vector<uint32_t> &output) noexcept {
+    for(auto index : indices) {
+        auto id = object_changes_id(index);
+        if(id != NULL_ID) output.push_back(id);
+    }
+}
+
+void find_objects_near(const Vector3D &point, float radius, std::vector<uint32_t> &output) noexcept {
+    std::vector<uint32_t> indices;
+    object_grid.find_in_radius(point, radius, indices);
+    append_object_ids(indices, output);
+}
+
+void find_nearest_objects(const Vector3D &point, size_t count, std::vector<uint32_t> &output) noexcept {
+    std::vector<uint32_t> indices;
+    object_grid.find_nearest(point, count, indices);
+    append_object_ids(indices, output);
+}
+
+void setup_object_grid() noexcept {
+    add_tick_event(update_object_grid, EVENT_PRIORITY_BEFORE);
+    add_map_load_event(clear_object_grid, EVENT_PRIORITY_BEFORE);
+}
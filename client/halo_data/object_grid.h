@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "../../math/data_types.h"
+
+/// Append the IDs of objects within radius of point to output, in no particular order. Positions are as of the last tick.
+void find_objects_near(const Vector3D &point, float radius, std::vector<uint32_t> &output) noexcept;
+
+/// Append the IDs of the count objects nearest to point to output, nearest first. Positions are as of the last tick.
+void find_nearest_objects(const Vector3D &point, size_t count, std::vector<uint32_t> &output) noexcept;
+
+/// Start keeping the object grid up to date. This must be called after setup_object_changes().
+void setup_object_grid() noexcept;
@@ -1,4 +1,5 @@
 #include "table.h"
+#include "hash_index.h"
 #include "../client_signature.h"
 
 MovementInfo &get_movement_info() noexcept {
@@ -81,43 +82,105 @@ uint32_t HaloPlayer::object_id() noexcept {
 }
 
 char *HaloPlayer::player_data() noexcept {
-    GenericTable &pt = get_player_table();
-    if(this->player_index >= pt.size || this->player_index >= pt.max_count) return nullptr;
-    auto *data = reinterpret_cast<char *>(pt.first) + this->player_index * pt.index_size;
-    if(*reinterpret_cast<uint16_t *>(data) == 0xFFFF) return nullptr;
-    return data;
+    return TableView<char>(get_player_table()).get(this->player_index);
 }
 
 HaloPlayer::HaloPlayer(uint32_t player_index) noexcept {
     this->player_index = player_index & 0xFFFF;
 }
 
-HaloPlayer::HaloPlayer(const short *name) noexcept {
-    GenericTable &pt = get_player_table();
-    auto *p = reinterpret_cast<char *>(pt.first);
-    for(size_t i=0;i<pt.size;i++) {
-        auto *pl = p + i * pt.index_size;
-        if(*reinterpret_cast<uint16_t *>(pl) == 0xFFFF) continue;
-        if(unichar_equal(name,(const short *)(pl + 4), HALO_NAME_LENGTH)) {
-            this->player_index = i;
-            return;
-        }
+// Player name index
+//
+// This is an open addressing hash table of player indices keyed on case-folded names. It's rebuilt when a player joins
+// or leaves, which is when the player table's count or next ID changes. Hits are always checked against the player's
+// current name, so a stale index can only cause a miss.
+struct PlayerNameIndexKey {
+    void *first;
+    uint16_t count;
+    uint16_t next_id;
+};
+
+static PlayerNameIndexKey player_name_index_key = {};
+static HashIndex player_name_index;
+
+static inline uint16_t name_unit(char c) noexcept {
+    return static_cast<unsigned char>(c);
+}
+
+static inline uint16_t name_unit(short c) noexcept {
+    return static_cast<uint16_t>(c);
+}
+
+// Fold ASCII and Latin-1 letters to lowercase.
+static inline uint16_t fold_name_unit(uint16_t c) noexcept {
+    if((c >= 'A' && c <= 'Z') || (c >= 0xC0 && c <= 0xDE && c != 0xD7)) return c + 0x20;
+    return c;
+}
+
+template<typename T>
+static uint32_t hash_player_name(const T *name) noexcept {
+    uint32_t hash = FNV1A_OFFSET_BASIS;
+    for(size_t i=0;i<HALO_NAME_LENGTH && name[i];i++) {
+        hash = fnv1a(hash, fold_name_unit(name_unit(name[i])));
     }
-    this->player_index = 0xFFFF;
+    return hash;
 }
 
-HaloPlayer::HaloPlayer(const char *name) noexcept {
-    GenericTable &pt = get_player_table();
-    auto *p = reinterpret_cast<char *>(pt.first);
-    for(size_t i=0;i<pt.size;i++) {
-        auto *pl = p + i * pt.index_size;
-        if(*reinterpret_cast<uint16_t *>(pl) == 0xFFFF) continue;
-        if(unichar_equal(name,(const short *)(pl + 4), HALO_NAME_LENGTH)) {
-            this->player_index = i;
-            return;
-        }
+template<typename T>
+static bool player_name_equal(const T *name, const short *player_name, bool fold) noexcept {
+    for(size_t i=0;i<HALO_NAME_LENGTH;i++) {
+        uint16_t a = name_unit(name[i]);
+        uint16_t b = name_unit(player_name[i]);
+        if(fold ? fold_name_unit(a) != fold_name_unit(b) : a != b) return false;
+        if(a == 0) return true;
     }
-    this->player_index = 0xFFFF;
+    return name[HALO_NAME_LENGTH] == 0;
+}
+
+static const short *player_name(const char *player) noexcept {
+    return reinterpret_cast<const short *>(player + 4);
+}
+
+static const HashIndex &get_player_name_index() noexcept {
+    auto &pt = get_player_table();
+    auto &key = player_name_index_key;
+    if(key.first == pt.first && key.count == pt.count && key.next_id == pt.next_id && !player_name_index.empty()) return player_name_index;
+    key = PlayerNameIndexKey { pt.first, pt.count, pt.next_id };
+
+    TableView<char> players(pt);
+    player_name_index.reset(players.max_count());
+    for(auto player = players.begin(); player != players.end(); ++player) {
+        player_name_index.insert(hash_player_name(player_name(&*player)), static_cast<uint32_t>(player.index()));
+    }
+    return player_name_index;
+}
+
+// Find a player by name. An exact match is preferred over one that only differs by case.
+template<typename T>
+static uint32_t find_player_by_name(const T *name) noexcept {
+    if(name == nullptr || name[0] == 0) return 0xFFFF;
+    TableView<char> players(get_player_table());
+    uint32_t exact_match = 0xFFFF;
+    uint32_t folded_match = 0xFFFF;
+    get_player_name_index().find(hash_player_name(name), [&](uint32_t player_index) {
+        auto *player = players.get(player_index);
+        if(!player) return false;
+        if(player_name_equal(name, player_name(player), false)) {
+            exact_match = player_index;
+            return true;
+        }
+        if(folded_match == 0xFFFF && player_name_equal(name, player_name(player), true)) folded_match = player_index;
+        return false;
+    });
+    return exact_match != 0xFFFF ? exact_match : folded_match;
+}
+
+HaloPlayer::HaloPlayer(const short *name) noexcept {
+    this->player_index = find_player_by_name(name);
+}
+
+HaloPlayer::HaloPlayer(const char *name) noexcept {
+    this->player_index = find_player_by_name(name);
 }
 
 uint32_t HaloObject::index() noexcept {
@@ -125,9 +188,9 @@ uint32_t HaloObject::index() noexcept {
 }
 
 char *HaloObject::object_data() noexcept {
-    auto &ot = get_object_table();
-    if((this->object_index & 0xFFFF) > ot.max_count) return nullptr;
-    return *reinterpret_cast<char **>(reinterpret_cast<char *>(ot.first) + (this->object_index & 0xFFFF) * ot.index_size + 0x8);
+    auto *entry = TableView<char>(get_object_table()).get(this->object_index & 0xFFFF);
+    if(!entry) return nullptr;
+    return *reinterpret_cast<char **>(entry + 0x8);
 }
 
 HaloObject::HaloObject(uint32_t object_index) noexcept {
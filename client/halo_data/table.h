@@ -1,8 +1,10 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include "../../math/data_types.h"
 #include "tag_data.h"
+#include "table_view.h"
 
 #define HALO_NAME_LENGTH 12
 #define NULL_ID 0xFFFFFFFF
@@ -44,20 +46,6 @@ struct MovementInfo {
 /// Retrieve the movement info.
 MovementInfo &get_movement_info() noexcept;
 
-/// Halo's tables are mapped out like this.
-struct GenericTable {
-    char name[0x20];
-    uint16_t max_count;
-    uint16_t index_size;
-    uint32_t one;
-    uint32_t data_v;
-    uint16_t zero;
-    uint16_t size;
-    uint16_t count;
-    uint16_t next_id;
-    void *first;
-};
-
 /// Return a reference to the object table.
 GenericTable &get_object_table() noexcept;
 
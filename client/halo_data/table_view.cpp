@@ -0,0 +1,13 @@
+#include "table_view.h"
+#include "../../math/batch.h"
+
+void table_live_slots(const GenericTable &table, size_t first_index, uint32_t (&masks)[TABLE_LIVE_SLOTS_BLOCK / 32]) noexcept {
+    for(auto &mask : masks) {
+        mask = 0;
+    }
+    size_t size = table.size < table.max_count ? table.size : table.max_count;
+    if(first_index >= size) return;
+    size_t count = size - first_index < TABLE_LIVE_SLOTS_BLOCK ? size - first_index : TABLE_LIVE_SLOTS_BLOCK;
+    auto *salts = reinterpret_cast<const uint16_t *>(reinterpret_cast<const char *>(table.first) + first_index * table.index_size);
+    batch_live_slots(Span<const uint16_t>(salts, count, table.index_size), masks);
+}
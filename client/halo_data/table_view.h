@@ -0,0 +1,160 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Halo's tables are mapped out like this.
+struct GenericTable {
+    char name[0x20];
+    uint16_t max_count;
+    uint16_t index_size;
+    uint32_t one;
+    uint32_t data_v;
+    uint16_t zero;
+    uint16_t size;
+    uint16_t count;
+    uint16_t next_id;
+    void *first;
+};
+
+/// Number of slots table_live_slots() checks at once. Each call has some overhead, so this is more than one mask's worth.
+#define TABLE_LIVE_SLOTS_BLOCK 256
+
+/// Get masks of the live slots in the TABLE_LIVE_SLOTS_BLOCK slots of a table starting at first_index. Bit i of mask w is
+/// set if slot first_index + w * 32 + i is live. Slots past the end of the table are not live.
+void table_live_slots(const GenericTable &table, size_t first_index, uint32_t (&masks)[TABLE_LIVE_SLOTS_BLOCK / 32]) noexcept;
+
+/// This is a typed view of one of Halo's tables. Every entry starts with a 16-bit salt, which is 0 or 0xFFFF if the slot
+/// is free. Entries are index_size bytes apart, so T only needs to cover as much of the entry as is used.
+template<typename T>
+class TableView {
+public:
+    TableView(GenericTable &table) noexcept : table(table) {}
+
+    /// Get the number of live entries.
+    size_t count() const noexcept {
+        return this->table.count;
+    }
+
+    /// Get the maximum number of entries the table can hold.
+    size_t max_count() const noexcept {
+        return this->table.max_count;
+    }
+
+    /// Get the number of slots at the start of the table that have been used, clamped to max_count. Slots past this
+    /// are never live.
+    size_t size() const noexcept {
+        return this->table.size < this->table.max_count ? this->table.size : this->table.max_count;
+    }
+
+    /// Get the entry at index whether or not it's live, or nullptr if index is out of bounds.
+    T *at(size_t index) const noexcept {
+        if(index >= this->max_count()) return nullptr;
+        return reinterpret_cast<T *>(reinterpret_cast<char *>(this->table.first) + index * this->table.index_size);
+    }
+
+    /// Get the entry at index, or nullptr if it's out of bounds or not live.
+    T *get(size_t index) const noexcept {
+        if(index >= this->size()) return nullptr;
+        auto *entry = this->at(index);
+        auto salt = *reinterpret_cast<uint16_t *>(entry);
+        return salt == 0 || salt == 0xFFFF ? nullptr : entry;
+    }
+
+    /// This iterates through live entries only, in index order.
+    class iterator {
+    public:
+        iterator(const TableView &view, size_t base) noexcept : view(view), base(base) {
+            this->next_block();
+        }
+
+        /// Get the index of the current entry.
+        size_t index() const noexcept {
+            return this->base + this->word * 32 + this->offset;
+        }
+
+        T &operator*() const noexcept {
+            return *this->view.at(this->index());
+        }
+
+        T *operator->() const noexcept {
+            return this->view.at(this->index());
+        }
+
+        iterator &operator++() noexcept {
+            this->mask &= this->mask - 1;
+            if(this->mask || this->next_word()) this->offset = count_trailing_zeros(this->mask);
+            else {
+                this->base += TABLE_LIVE_SLOTS_BLOCK;
+                this->next_block();
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator &other) const noexcept {
+            return this->index() == other.index();
+        }
+
+        bool operator!=(const iterator &other) const noexcept {
+            return this->index() != other.index();
+        }
+
+    private:
+        const TableView &view;
+        size_t base;
+        size_t word = 0;
+        size_t offset = 0;
+        uint32_t mask = 0;
+        uint32_t masks[TABLE_LIVE_SLOTS_BLOCK / 32];
+
+        // Move to the next mask in this block with anything live in it. Return false if there isn't one.
+        bool next_word() noexcept {
+            while(++this->word < TABLE_LIVE_SLOTS_BLOCK / 32) {
+                this->mask = this->masks[this->word];
+                if(this->mask) return true;
+            }
+            return false;
+        }
+
+        // Find the next block of slots with anything live in it, or stop at the end of the table.
+        void next_block() noexcept {
+            size_t size = this->view.size();
+            for(; this->base < size; this->base += TABLE_LIVE_SLOTS_BLOCK) {
+                table_live_slots(this->view.table, this->base, this->masks);
+                this->word = 0;
+                this->mask = this->masks[0];
+                if(this->mask || this->next_word()) {
+                    this->offset = count_trailing_zeros(this->mask);
+                    return;
+                }
+            }
+            this->base = size;
+            this->word = 0;
+            this->offset = 0;
+        }
+
+        static size_t count_trailing_zeros(uint32_t mask) noexcept {
+#ifdef __GNUC__
+            return __builtin_ctz(mask);
+#else
+            size_t count = 0;
+            while(!(mask & 1)) {
+                mask >>= 1;
+                count++;
+            }
+            return count;
+#endif
+        }
+    };
+
+    iterator begin() const noexcept {
+        return iterator(*this, 0);
+    }
+
+    iterator end() const noexcept {
+        return iterator(*this, this->size());
+    }
+
+private:
+    GenericTable &table;
+};
@@ -0,0 +1,191 @@
+// Check TableView and table_live_slots() against a plain loop over the salts of random synthetic tables, with every
+// instruction set the CPU supports, and time a full iteration of each table.
+//
+// Usage: table_view_test
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "table_view.h"
+#include "../../math/batch.h"
+
+#define TABLE_COUNT 200
+
+// Entry sizes of some of Halo's tables (players, objects, particles, antennas) and a few odd ones
+static const uint16_t index_sizes[] = { 0x200, 0xC, 0x70, 0x19C, 0x2, 0x4, 0x6 };
+
+struct SyntheticTable {
+    GenericTable table = {};
+    std::vector<char> data;
+
+    uint16_t &salt(size_t index) noexcept {
+        return *reinterpret_cast<uint16_t *>(this->data.data() + index * this->table.index_size);
+    }
+};
+
+// Make a table with some mix of free and live slots. Slots are marked free with 0 or 0xFFFF, and used slots can have
+// any other salt, including ones with the high bit set. The used size is sometimes past max_count to check that it's
+// clamped.
+static void make_table(SyntheticTable &synthetic, size_t seed) noexcept {
+    auto &table = synthetic.table;
+    strcpy(table.name, "synthetic");
+    table.max_count = static_cast<uint16_t>(1 + rand() % 2048);
+    table.index_size = index_sizes[seed % (sizeof(index_sizes) / sizeof(*index_sizes))];
+    table.size = static_cast<uint16_t>(seed % 10 == 0 ? table.max_count + rand() % 64 : rand() % (table.max_count + 1));
+
+    synthetic.data.assign(static_cast<size_t>(table.max_count) * table.index_size, 0);
+    table.first = synthetic.data.data();
+
+    int live_percent = rand() % 101;
+    size_t count = 0;
+    for(size_t i = 0; i < table.max_count; i++) {
+        if(rand() % 100 < live_percent) {
+            static const uint16_t salts[] = { 0xE000, 0x8000, 0xE123, 0x0001, 0x7FFF, 0xFFFE };
+            synthetic.salt(i) = salts[rand() % (sizeof(salts) / sizeof(*salts))];
+            if(i < table.size) count++;
+        }
+        else {
+            synthetic.salt(i) = rand() % 2 ? 0 : 0xFFFF;
+        }
+    }
+    table.count = static_cast<uint16_t>(count);
+}
+
+static bool reference_live(SyntheticTable &synthetic, size_t index) noexcept {
+    size_t size = synthetic.table.size < synthetic.table.max_count ? synthetic.table.size : synthetic.table.max_count;
+    if(index >= size) return false;
+    auto salt = synthetic.salt(index);
+    return salt != 0 && salt != 0xFFFF;
+}
+
+static size_t failures = 0;
+
+static void check_table(SyntheticTable &synthetic, size_t table_number) noexcept {
+    TableView<char> view(synthetic.table);
+
+    // Masks, including blocks that don't start on a multiple of 32 and blocks that run past the end of the table
+    for(size_t base = 0; base < synthetic.table.max_count + 64u; base += 32 + base % 7) {
+        uint32_t masks[TABLE_LIVE_SLOTS_BLOCK / 32];
+        table_live_slots(synthetic.table, base, masks);
+        for(size_t w = 0; w < TABLE_LIVE_SLOTS_BLOCK / 32; w++) {
+            uint32_t expected = 0;
+            for(size_t i = 0; i < 32; i++) {
+                if(reference_live(synthetic, base + w * 32 + i)) expected |= 1u << i;
+            }
+            if(masks[w] != expected) {
+                fprintf(stderr, "    table %zu: mask at %zu is %08X instead of %08X\n", table_number, base + w * 32, masks[w], expected);
+                failures++;
+                return;
+            }
+        }
+    }
+
+    // get()
+    for(size_t i = 0; i < synthetic.table.max_count + 2u; i++) {
+        bool live = view.get(i) != nullptr;
+        if(live != reference_live(synthetic, i)) {
+            fprintf(stderr, "    table %zu: get(%zu) is wrong\n", table_number, i);
+            failures++;
+            return;
+        }
+    }
+
+    // Iteration should visit every live slot once, in order, with the entry at that slot.
+    std::vector<size_t> expected;
+    for(size_t i = 0; i < synthetic.table.max_count; i++) {
+        if(reference_live(synthetic, i)) expected.push_back(i);
+    }
+    std::vector<size_t> visited;
+    for(auto it = view.begin(); it != view.end(); ++it) {
+        if(&*it != view.at(it.index())) {
+            fprintf(stderr, "    table %zu: iterator points to the wrong entry at %zu\n", table_number, it.index());
+            failures++;
+            return;
+        }
+        visited.push_back(it.index());
+        if(visited.size() > expected.size()) break;
+    }
+    if(visited != expected) {
+        fprintf(stderr, "    table %zu: iterator visited %zu slots instead of %zu\n", table_number, visited.size(), expected.size());
+        failures++;
+    }
+}
+
+// Stands in for the work a real loop does with each live entry. It's kept out of line so neither loop below can turn the
+// salt check into a conditional move, which no real loop could do either.
+static size_t visited_sum = 0;
+
+__attribute__((noinline)) static void visit(size_t index) noexcept {
+    visited_sum += index;
+}
+
+// Time visiting every live entry of every table with the view and with the kind of loop it replaced, which checks each
+// salt in turn.
+static void time_tables(std::vector<SyntheticTable> &tables) noexcept {
+    size_t slots = 0;
+    visited_sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(size_t repeat = 0; repeat < 100; repeat++) {
+        for(auto &synthetic : tables) {
+            TableView<char> view(synthetic.table);
+            for(auto it = view.begin(), end = view.end(); it != end; ++it) {
+                visit(it.index());
+            }
+            slots += view.size();
+        }
+    }
+    auto view_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    size_t view_sum = visited_sum;
+
+    visited_sum = 0;
+    start = std::chrono::steady_clock::now();
+    for(size_t repeat = 0; repeat < 100; repeat++) {
+        for(auto &synthetic : tables) {
+            TableView<char> view(synthetic.table);
+            for(size_t i = 0; i < view.size(); i++) {
+                auto salt = synthetic.salt(i);
+                if(salt != 0 && salt != 0xFFFF) visit(i);
+            }
+        }
+    }
+    auto loop_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    printf("    %.3f ns per slot (%.3f with a loop over every salt)\n", static_cast<double>(view_ns) / slots, static_cast<double>(loop_ns) / slots);
+    if(view_sum != visited_sum) {
+        printf("    view and loop visited different entries\n");
+        failures++;
+    }
+}
+
+int main() {
+    static const char *names[] = { "scalar", "SSE2", "AVX2" };
+
+    srand(4321);
+    std::vector<SyntheticTable> tables(TABLE_COUNT);
+    for(size_t t = 0; t < tables.size(); t++) {
+        make_table(tables[t], t);
+    }
+
+    for(int i = BATCH_INSTRUCTION_SET_SCALAR; i <= BATCH_INSTRUCTION_SET_AVX2; i++) {
+        auto instruction_set = static_cast<BatchInstructionSet>(i);
+        if(batch_set_instruction_set(instruction_set) != instruction_set) {
+            printf("%s: not supported by this CPU; skipped\n", names[i]);
+            continue;
+        }
+        printf("%s:\n", names[i]);
+        size_t failures_before = failures;
+        for(size_t t = 0; t < tables.size(); t++) {
+            check_table(tables[t], t);
+        }
+        printf("    %zu tables %s\n", tables.size(), failures == failures_before ? "ok" : "FAILED");
+        time_tables(tables);
+    }
+
+    if(failures) {
+        printf("%zu tables failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
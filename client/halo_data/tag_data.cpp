@@ -1,6 +1,7 @@
-#include <exception>
+#include <ctype.h>
 #include <string.h>
 #include "tag_data.h"
+#include "hash_index.h"
 #include "tiarace/hce_tag_class_int.h"
 
 bool HaloTagID::is_null() const noexcept {
@@ -31,7 +32,63 @@ HaloTag &HaloTag::from_id(const HaloTagID &tag_id) noexcept {
     return (*reinterpret_cast<HaloTag **>(0x40440000))[tag_id.index];
 }
 
-HaloTag &HaloTag::lookup(const char *tag_class, const char *tag_path) {
+bool TagDataKey::operator==(const TagDataKey &other) const noexcept {
+    return memcmp(this, &other, sizeof(other)) == 0;
+}
+
+bool TagDataKey::operator!=(const TagDataKey &other) const noexcept {
+    return !(*this == other);
+}
+
+TagDataKey tag_data_key() noexcept {
+    auto *tag_data = reinterpret_cast<uint32_t *>(0x40440000);
+    return TagDataKey { tag_data[0], tag_data[3], tag_data[2], tag_data[1] };
+}
+
+// Tag path index
+//
+// This is an open addressing hash table of tag indices keyed on tag class and path (case-insensitive). It's rebuilt the
+// first time a tag is looked up after a different map is loaded.
+
+static TagDataKey tag_index_key = {};
+static HashIndex tag_index;
+
+static uint32_t hash_tag(uint32_t tag_class, const char *tag_path) noexcept {
+    uint32_t hash = FNV1A_OFFSET_BASIS;
+    for(int i=0;i<4;i++) {
+        hash = fnv1a(hash, (tag_class >> (i * 8)) & 0xFF);
+    }
+    for(const char *c = tag_path; *c; c++) {
+        hash = fnv1a(hash, static_cast<unsigned char>(tolower(*c)));
+    }
+    return hash;
+}
+
+static const HashIndex &get_tag_index() noexcept {
+    auto key = tag_data_key();
+    if(key == tag_index_key && !tag_index.empty()) return tag_index;
+    tag_index_key = key;
+
+    tag_index.reset(key.tag_count);
+    for(uint32_t i=0;i<key.tag_count;i++) {
+        auto &tag = HaloTag::from_id(i);
+        tag_index.insert(hash_tag(tag.tag_class, tag.path), i);
+    }
+    return tag_index;
+}
+
+HaloTag *HaloTag::lookup(uint32_t tag_class, const char *tag_path) noexcept {
+    HaloTag *found = nullptr;
+    get_tag_index().find(hash_tag(tag_class, tag_path), [&found, tag_class, tag_path](uint32_t i) {
+        auto &tag = HaloTag::from_id(i);
+        if(tag.tag_class != tag_class || _stricmp(tag.path, tag_path) != 0) return false;
+        found = &tag;
+        return true;
+    });
+    return found;
+}
+
+HaloTag *HaloTag::lookup(const char *tag_class, const char *tag_path) noexcept {
     uint32_t tag_class_int;
     if(strlen(tag_class) > 4) {
         tag_class_int = HaloCE::tag_class_int_from_string(tag_class);
@@ -50,12 +107,5 @@ HaloTag &HaloTag::lookup(const char *tag_class, const char *tag_path) {
         }
         tag_class_int = *reinterpret_cast<uint32_t *>(tag_class_buf);
     }
-
-    for(size_t i=0;i<*reinterpret_cast<uint32_t *>(0x4044000C);i++) {
-        auto &tag = HaloTag::from_id(i);
-        if(tag.tag_class == tag_class_int && strcmp(tag.path, tag_path) == 0) {
-            return tag;
-        }
-    }
-    throw std::exception();
+    return lookup(tag_class_int, tag_path);
 }
@@ -14,6 +14,21 @@ union HaloTagID {
     operator unsigned int() const noexcept;
 };
 
+/// Identifies the tag data that's loaded. This changes whenever a different map is loaded, so anything built from tag
+/// data can be cached until it does.
+struct TagDataKey {
+    uint32_t tag_array;
+    uint32_t tag_count;
+    uint32_t checksum;
+    uint32_t scenario_tag_id;
+
+    bool operator==(const TagDataKey &other) const noexcept;
+    bool operator!=(const TagDataKey &other) const noexcept;
+};
+
+/// Get the key of the tag data that's currently loaded.
+TagDataKey tag_data_key() noexcept;
+
 struct HaloTagDependency {
     uint32_t tag_class;
     char *tag_path;
@@ -31,5 +46,11 @@ struct HaloTag {
     char dont_care[0x8];
 
     static HaloTag &from_id(const HaloTagID &tag_id) noexcept;
-    static HaloTag &lookup(const char *tag_class, const char *tag_path);
+
+    /// Find a tag by class (as a string such as "weapon" or a four character code such as "weap") and path. Paths are
+    /// case-insensitive. Return nullptr if it doesn't exist.
+    static HaloTag *lookup(const char *tag_class, const char *tag_path) noexcept;
+
+    /// Find a tag by class and path. Paths are case-insensitive. Return nullptr if it doesn't exist.
+    static HaloTag *lookup(uint32_t tag_class, const char *tag_path) noexcept;
 };
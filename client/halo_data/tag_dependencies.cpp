@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <vector>
+#include "map.h"
+#include "tag_dependencies.h"
+#include "../../map/tag_data_view.h"
+
+// Tag dependency graph
+//
+// Every reference in tag data is found once per map and stored in both directions as compressed sparse rows: the
+// neighbors of tag i are ids[offsets[i]] through ids[offsets[i + 1] - 1]. Like the tag path index, it's built the first
+// time it's needed after a different map is loaded.
+struct TagDependencyRows {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> ids;
+};
+
+static TagDataKey dependency_graph_key = {};
+static TagDependencyRows dependencies_rows;
+static TagDependencyRows dependents_rows;
+
+struct TagDependencyEdge {
+    uint32_t from;
+    uint32_t to;
+
+    bool operator<(const TagDependencyEdge &other) const noexcept {
+        return this->from < other.from || (this->from == other.from && this->to < other.to);
+    }
+    bool operator==(const TagDependencyEdge &other) const noexcept {
+        return this->from == other.from && this->to == other.to;
+    }
+};
+
+static bool add_dependency_edge(const MapDependency &dependency, void *user) noexcept {
+    reinterpret_cast<std::vector<TagDependencyEdge> *>(user)->push_back(TagDependencyEdge { dependency.tag_index, dependency.target_index });
+    return true;
+}
+
+static void build_dependency_graph(const TagDataKey &key) noexcept {
+    std::vector<TagDependencyEdge> edges;
+    TagDataView tag_data(reinterpret_cast<const void *>(MAP_TAG_DATA_ADDRESS), get_map_header().tag_data_size);
+    tag_data.for_each_dependency(add_dependency_edge, &edges);
+
+    // Tags often reference the same tag more than once, but each edge only needs to be stored once.
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    auto *tags = tag_data.tags();
+    uint32_t tag_count = tag_data.tag_count();
+    dependencies_rows.offsets.assign(tag_count + 1, 0);
+    dependents_rows.offsets.assign(tag_count + 1, 0);
+    for(auto &edge : edges) {
+        dependencies_rows.offsets[edge.from + 1]++;
+        dependents_rows.offsets[edge.to + 1]++;
+    }
+    for(uint32_t i=0;i<tag_count;i++) {
+        dependencies_rows.offsets[i + 1] += dependencies_rows.offsets[i];
+        dependents_rows.offsets[i + 1] += dependents_rows.offsets[i];
+    }
+
+    // Edges are sorted by source, so filling both in order leaves every row sorted by tag index.
+    dependencies_rows.ids.resize(edges.size());
+    dependents_rows.ids.resize(edges.size());
+    std::vector<uint32_t> next(dependents_rows.offsets.begin(), dependents_rows.offsets.end() - 1);
+    for(size_t e=0;e<edges.size();e++) {
+        dependencies_rows.ids[e] = tags[edges[e].to].tag_id;
+        dependents_rows.ids[next[edges[e].to]++] = tags[edges[e].from].tag_id;
+    }
+
+    dependency_graph_key = key;
+}
+
+static const uint32_t *get_row(const TagDependencyRows &rows, const HaloTagID &tag_id, size_t &count) noexcept {
+    count = 0;
+    if(!tag_id.is_valid()) return nullptr;
+
+    auto key = tag_data_key();
+    if(key != dependency_graph_key || dependencies_rows.offsets.empty()) build_dependency_graph(key);
+    if(tag_id.index + 1u >= rows.offsets.size()) return nullptr;
+
+    count = rows.offsets[tag_id.index + 1] - rows.offsets[tag_id.index];
+    return rows.ids.data() + rows.offsets[tag_id.index];
+}
+
+const uint32_t *tag_dependencies(const HaloTagID &tag_id, size_t &count) noexcept {
+    return get_row(dependencies_rows, tag_id, count);
+}
+
+const uint32_t *tag_dependents(const HaloTagID &tag_id, size_t &count) noexcept {
+    return get_row(dependents_rows, tag_id, count);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tag_data.h"
+
+/// Get the IDs of the tags that a tag references, sorted by tag index. The number of tags is written to count. The array
+/// is valid until a different map is loaded. Return nullptr if the tag ID isn't valid.
+const uint32_t *tag_dependencies(const HaloTagID &tag_id, size_t &count) noexcept;
+
+/// Get the IDs of the tags that reference a tag, sorted by tag index. The number of tags is written to count. The array
+/// is valid until a different map is loaded. Return nullptr if the tag ID isn't valid.
+const uint32_t *tag_dependents(const HaloTagID &tag_id, size_t &count) noexcept;
@@ -1,5 +1,5 @@
 #include "hce_tag_class_int.h"
-#include <string.h>
+#include "../../perfect_hash.h"
 
 using namespace HaloCE;
 
@@ -94,173 +94,95 @@ const char *HaloCE::tag_class_string_from_int(TagClassInt i) noexcept {
     }
 }
 
+static constexpr PerfectHashEntry<TagClassInt> tag_class_names[] = {
+    { "actor", TAG_CLASS_INT_ACTOR },
+    { "actor_variant", TAG_CLASS_INT_ACTOR_VARIANT },
+    { "antenna", TAG_CLASS_INT_ANTENNA },
+    { "model_animations", TAG_CLASS_INT_MODEL_ANIMATIONS },
+    { "biped", TAG_CLASS_INT_BIPED },
+    { "bitmap", TAG_CLASS_INT_BITMAP },
+    { "spheroid", TAG_CLASS_INT_SPHEROID },
+    { "continuous_damage_effect", TAG_CLASS_INT_CONTINUOUS_DAMAGE_EFFECT },
+    { "model_collision_geometry", TAG_CLASS_INT_MODEL_COLLISION_GEOMETRY },
+    { "color_table", TAG_CLASS_INT_COLOR_TABLE },
+    { "contrail", TAG_CLASS_INT_CONTRAIL },
+    { "device_control", TAG_CLASS_INT_DEVICE_CONTROL },
+    { "decal", TAG_CLASS_INT_DECAL },
+    { "ui_widget_definition", TAG_CLASS_INT_UI_WIDGET_DEFINITION },
+    { "input_device_defaults", TAG_CLASS_INT_INPUT_DEVICE_DEFAULTS },
+    { "device", TAG_CLASS_INT_DEVICE },
+    { "detail_object_collection", TAG_CLASS_INT_DETAIL_OBJECT_COLLECTION },
+    { "effect", TAG_CLASS_INT_EFFECT },
+    { "equipment", TAG_CLASS_INT_EQUIPMENT },
+    { "flag", TAG_CLASS_INT_FLAG },
+    { "fog", TAG_CLASS_INT_FOG },
+    { "font", TAG_CLASS_INT_FONT },
+    { "lightning", TAG_CLASS_INT_LIGHTNING },
+    { "material_effects", TAG_CLASS_INT_MATERIAL_EFFECTS },
+    { "garbage", TAG_CLASS_INT_GARBAGE },
+    { "glow", TAG_CLASS_INT_GLOW },
+    { "grenade_hud_interface", TAG_CLASS_INT_GRENADE_HUD_INTERFACE },
+    { "hud_message_text", TAG_CLASS_INT_HUD_MESSAGE_TEXT },
+    { "hud_number", TAG_CLASS_INT_HUD_NUMBER },
+    { "hud_globals", TAG_CLASS_INT_HUD_GLOBALS },
+    { "item", TAG_CLASS_INT_ITEM },
+    { "item_collection", TAG_CLASS_INT_ITEM_COLLECTION },
+    { "damage_effect", TAG_CLASS_INT_DAMAGE_EFFECT },
+    { "lens_flare", TAG_CLASS_INT_LENS_FLARE },
+    { "device_light_fixture", TAG_CLASS_INT_DEVICE_LIGHT_FIXTURE },
+    { "light", TAG_CLASS_INT_LIGHT },
+    { "sound_looping", TAG_CLASS_INT_SOUND_LOOPING },
+    { "device_machine", TAG_CLASS_INT_DEVICE_MACHINE },
+    { "globals", TAG_CLASS_INT_GLOBALS },
+    { "meter", TAG_CLASS_INT_METER },
+    { "light_volume", TAG_CLASS_INT_LIGHT_VOLUME },
+    { "gbxmodel", TAG_CLASS_INT_GBXMODEL },
+    { "model", TAG_CLASS_INT_MODEL },
+    { "multiplayer_scenario_description", TAG_CLASS_INT_MULTIPLAYER_SCENARIO_DESCRIPTION },
+    { "preferences_network_game", TAG_CLASS_INT_PREFERENCES_NETWORK_GAME },
+    { "object", TAG_CLASS_INT_OBJECT },
+    { "particle", TAG_CLASS_INT_PARTICLE },
+    { "particle_system", TAG_CLASS_INT_PARTICLE_SYSTEM },
+    { "physics", TAG_CLASS_INT_PHYSICS },
+    { "placeholder", TAG_CLASS_INT_PLACEHOLDER },
+    { "point_physics", TAG_CLASS_INT_POINT_PHYSICS },
+    { "projectile", TAG_CLASS_INT_PROJECTILE },
+    { "weather", TAG_CLASS_INT_WEATHER },
+    { "scenario_structure_bsp", TAG_CLASS_INT_SCENARIO_STRUCTURE_BSP },
+    { "scenery", TAG_CLASS_INT_SCENERY },
+    { "shader_transparent_chicago_extended", TAG_CLASS_INT_SHADER_TRANSPARENT_CHICAGO_EXTENDED },
+    { "shader_transparent_chicago", TAG_CLASS_INT_SHADER_TRANSPARENT_CHICAGO },
+    { "scenario", TAG_CLASS_INT_SCENARIO },
+    { "shader_environment", TAG_CLASS_INT_SHADER_ENVIRONMENT },
+    { "transparent_glass", TAG_CLASS_INT_SHADER_TRANSPARENT_GLASS },
+    { "shader", TAG_CLASS_INT_SHADER },
+    { "sky", TAG_CLASS_INT_SKY },
+    { "shader_transparent_meter", TAG_CLASS_INT_SHADER_TRANSPARENT_METER },
+    { "sound", TAG_CLASS_INT_SOUND },
+    { "sound_environment", TAG_CLASS_INT_SOUND_ENVIRONMENT },
+    { "shader_model", TAG_CLASS_INT_SHADER_MODEL },
+    { "shader_transparent_generic", TAG_CLASS_INT_SHADER_TRANSPARENT_GENERIC },
+    { "ui_widget_collection", TAG_CLASS_INT_UI_WIDGET_COLLECTION },
+    { "shader_transparent_plasma", TAG_CLASS_INT_SHADER_TRANSPARENT_PLASMA },
+    { "sound_scenery", TAG_CLASS_INT_SOUND_SCENERY },
+    { "string_list", TAG_CLASS_INT_STRING_LIST },
+    { "shader_transparent_water", TAG_CLASS_INT_SHADER_TRANSPARENT_WATER },
+    { "tag_collection", TAG_CLASS_INT_TAG_COLLECTION },
+    { "camera_track", TAG_CLASS_INT_CAMERA_TRACK },
+    { "unit_dialogue", TAG_CLASS_INT_UNIT_DIALOGUE },
+    { "unit_hud_interface", TAG_CLASS_INT_UNIT_HUD_INTERFACE },
+    { "unit", TAG_CLASS_INT_UNIT },
+    { "unicode_string_list", TAG_CLASS_INT_UNICODE_STRING_LIST },
+    { "virtual_keyboard", TAG_CLASS_INT_VIRTUAL_KEYBOARD },
+    { "vehicle", TAG_CLASS_INT_VEHICLE },
+    { "weapon", TAG_CLASS_INT_WEAPON },
+    { "wind", TAG_CLASS_INT_WIND },
+    { "weapon_hud_interface", TAG_CLASS_INT_WEAPON_HUD_INTERFACE }
+};
+
+static constexpr auto tag_class_name_map = make_perfect_hash_map(tag_class_names, TAG_CLASS_INT_NONE);
+static_assert(tag_class_name_map.valid(), "tag class names must be unique");
+
 TagClassInt HaloCE::tag_class_int_from_string(const char *i) noexcept {
-    if (strcmp(i, "actor") == 0)
-        return TAG_CLASS_INT_ACTOR;
-    else if (strcmp(i, "actor_variant") == 0)
-        return TAG_CLASS_INT_ACTOR_VARIANT;
-    else if (strcmp(i, "antenna") == 0)
-        return TAG_CLASS_INT_ANTENNA;
-    else if (strcmp(i, "model_animations") == 0)
-        return TAG_CLASS_INT_MODEL_ANIMATIONS;
-    else if (strcmp(i, "biped") == 0)
-        return TAG_CLASS_INT_BIPED;
-    else if (strcmp(i, "bitmap") == 0)
-        return TAG_CLASS_INT_BITMAP;
-    else if (strcmp(i, "spheroid") == 0)
-        return TAG_CLASS_INT_SPHEROID;
-    else if (strcmp(i, "continuous_damage_effect") == 0)
-        return TAG_CLASS_INT_CONTINUOUS_DAMAGE_EFFECT;
-    else if (strcmp(i, "model_collision_geometry") == 0)
-        return TAG_CLASS_INT_MODEL_COLLISION_GEOMETRY;
-    else if (strcmp(i, "color_table") == 0)
-        return TAG_CLASS_INT_COLOR_TABLE;
-    else if (strcmp(i, "contrail") == 0)
-        return TAG_CLASS_INT_CONTRAIL;
-    else if (strcmp(i, "device_control") == 0)
-        return TAG_CLASS_INT_DEVICE_CONTROL;
-    else if (strcmp(i, "decal") == 0)
-        return TAG_CLASS_INT_DECAL;
-    else if (strcmp(i, "ui_widget_definition") == 0)
-        return TAG_CLASS_INT_UI_WIDGET_DEFINITION;
-    else if (strcmp(i, "input_device_defaults") == 0)
-        return TAG_CLASS_INT_INPUT_DEVICE_DEFAULTS;
-    else if (strcmp(i, "device") == 0)
-        return TAG_CLASS_INT_DEVICE;
-    else if (strcmp(i, "detail_object_collection") == 0)
-        return TAG_CLASS_INT_DETAIL_OBJECT_COLLECTION;
-    else if (strcmp(i, "effect") == 0)
-        return TAG_CLASS_INT_EFFECT;
-    else if (strcmp(i, "equipment") == 0)
-        return TAG_CLASS_INT_EQUIPMENT;
-    else if (strcmp(i, "flag") == 0)
-        return TAG_CLASS_INT_FLAG;
-    else if (strcmp(i, "fog") == 0)
-        return TAG_CLASS_INT_FOG;
-    else if (strcmp(i, "font") == 0)
-        return TAG_CLASS_INT_FONT;
-    else if (strcmp(i, "lightning") == 0)
-        return TAG_CLASS_INT_LIGHTNING;
-    else if (strcmp(i, "material_effects") == 0)
-        return TAG_CLASS_INT_MATERIAL_EFFECTS;
-    else if (strcmp(i, "garbage") == 0)
-        return TAG_CLASS_INT_GARBAGE;
-    else if (strcmp(i, "glow") == 0)
-        return TAG_CLASS_INT_GLOW;
-    else if (strcmp(i, "grenade_hud_interface") == 0)
-        return TAG_CLASS_INT_GRENADE_HUD_INTERFACE;
-    else if (strcmp(i, "hud_message_text") == 0)
-        return TAG_CLASS_INT_HUD_MESSAGE_TEXT;
-    else if (strcmp(i, "hud_number") == 0)
-        return TAG_CLASS_INT_HUD_NUMBER;
-    else if (strcmp(i, "hud_globals") == 0)
-        return TAG_CLASS_INT_HUD_GLOBALS;
-    else if (strcmp(i, "item") == 0)
-        return TAG_CLASS_INT_ITEM;
-    else if (strcmp(i, "item_collection") == 0)
-        return TAG_CLASS_INT_ITEM_COLLECTION;
-    else if (strcmp(i, "damage_effect") == 0)
-        return TAG_CLASS_INT_DAMAGE_EFFECT;
-    else if (strcmp(i, "lens_flare") == 0)
-        return TAG_CLASS_INT_LENS_FLARE;
-    else if (strcmp(i, "device_light_fixture") == 0)
-        return TAG_CLASS_INT_DEVICE_LIGHT_FIXTURE;
-    else if (strcmp(i, "light") == 0)
-        return TAG_CLASS_INT_LIGHT;
-    else if (strcmp(i, "sound_looping") == 0)
-        return TAG_CLASS_INT_SOUND_LOOPING;
-    else if (strcmp(i, "device_machine") == 0)
-        return TAG_CLASS_INT_DEVICE_MACHINE;
-    else if (strcmp(i, "globals") == 0)
-        return TAG_CLASS_INT_GLOBALS;
-    else if (strcmp(i, "meter") == 0)
-        return TAG_CLASS_INT_METER;
-    else if (strcmp(i, "light_volume") == 0)
-        return TAG_CLASS_INT_LIGHT_VOLUME;
-    else if (strcmp(i, "gbxmodel") == 0)
-        return TAG_CLASS_INT_GBXMODEL;
-    else if (strcmp(i, "model") == 0)
-        return TAG_CLASS_INT_MODEL;
-    else if (strcmp(i, "multiplayer_scenario_description") == 0)
-        return TAG_CLASS_INT_MULTIPLAYER_SCENARIO_DESCRIPTION;
-    else if (strcmp(i, "preferences_network_game") == 0)
-        return TAG_CLASS_INT_PREFERENCES_NETWORK_GAME;
-    else if (strcmp(i, "object") == 0)
-        return TAG_CLASS_INT_OBJECT;
-    else if (strcmp(i, "particle") == 0)
-        return TAG_CLASS_INT_PARTICLE;
-    else if (strcmp(i, "particle_system") == 0)
-        return TAG_CLASS_INT_PARTICLE_SYSTEM;
-    else if (strcmp(i, "physics") == 0)
-        return TAG_CLASS_INT_PHYSICS;
-    else if (strcmp(i, "placeholder") == 0)
-        return TAG_CLASS_INT_PLACEHOLDER;
-    else if (strcmp(i, "point_physics") == 0)
-        return TAG_CLASS_INT_POINT_PHYSICS;
-    else if (strcmp(i, "projectile") == 0)
-        return TAG_CLASS_INT_PROJECTILE;
-    else if (strcmp(i, "weather") == 0)
-        return TAG_CLASS_INT_WEATHER;
-    else if (strcmp(i, "scenario_structure_bsp") == 0)
-        return TAG_CLASS_INT_SCENARIO_STRUCTURE_BSP;
-    else if (strcmp(i, "scenery") == 0)
-        return TAG_CLASS_INT_SCENERY;
-    else if (strcmp(i, "shader_transparent_chicago_extended") == 0)
-        return TAG_CLASS_INT_SHADER_TRANSPARENT_CHICAGO_EXTENDED;
-    else if (strcmp(i, "shader_transparent_chicago") == 0)
-        return TAG_CLASS_INT_SHADER_TRANSPARENT_CHICAGO;
-    else if (strcmp(i, "scenario") == 0)
-        return TAG_CLASS_INT_SCENARIO;
-    else if (strcmp(i, "shader_environment") == 0)
-        return TAG_CLASS_INT_SHADER_ENVIRONMENT;
-    else if (strcmp(i, "transparent_glass") == 0)
-        return TAG_CLASS_INT_SHADER_TRANSPARENT_GLASS;
-    else if (strcmp(i, "shader") == 0)
-        return TAG_CLASS_INT_SHADER;
-    else if (strcmp(i, "sky") == 0)
-        return TAG_CLASS_INT_SKY;
-    else if (strcmp(i, "shader_transparent_meter") == 0)
-        return TAG_CLASS_INT_SHADER_TRANSPARENT_METER;
-    else if (strcmp(i, "sound") == 0)
-        return TAG_CLASS_INT_SOUND;
-    else if (strcmp(i, "sound_environment") == 0)
-        return TAG_CLASS_INT_SOUND_ENVIRONMENT;
-    else if (strcmp(i, "shader_model") == 0)
-        return TAG_CLASS_INT_SHADER_MODEL;
-    else if (strcmp(i, "shader_transparent_generic") == 0)
-        return TAG_CLASS_INT_SHADER_TRANSPARENT_GENERIC;
-    else if (strcmp(i, "ui_widget_collection") == 0)
-        return TAG_CLASS_INT_UI_WIDGET_COLLECTION;
-    else if (strcmp(i, "shader_transparent_plasma") == 0)
-        return TAG_CLASS_INT_SHADER_TRANSPARENT_PLASMA;
-    else if (strcmp(i, "sound_scenery") == 0)
-        return TAG_CLASS_INT_SOUND_SCENERY;
-    else if (strcmp(i, "string_list") == 0)
-        return TAG_CLASS_INT_STRING_LIST;
-    else if (strcmp(i, "shader_transparent_water") == 0)
-        return TAG_CLASS_INT_SHADER_TRANSPARENT_WATER;
-    else if (strcmp(i, "tag_collection") == 0)
-        return TAG_CLASS_INT_TAG_COLLECTION;
-    else if (strcmp(i, "camera_track") == 0)
-        return TAG_CLASS_INT_CAMERA_TRACK;
-    else if (strcmp(i, "unit_dialogue") == 0)
-        return TAG_CLASS_INT_UNIT_DIALOGUE;
-    else if (strcmp(i, "unit_hud_interface") == 0)
-        return TAG_CLASS_INT_UNIT_HUD_INTERFACE;
-    else if (strcmp(i, "unit") == 0)
-        return TAG_CLASS_INT_UNIT;
-    else if (strcmp(i, "unicode_string_list") == 0)
-        return TAG_CLASS_INT_UNICODE_STRING_LIST;
-    else if (strcmp(i, "virtual_keyboard") == 0)
-        return TAG_CLASS_INT_VIRTUAL_KEYBOARD;
-    else if (strcmp(i, "vehicle") == 0)
-        return TAG_CLASS_INT_VEHICLE;
-    else if (strcmp(i, "weapon") == 0)
-        return TAG_CLASS_INT_WEAPON;
-    else if (strcmp(i, "wind") == 0)
-        return TAG_CLASS_INT_WIND;
-    else if (strcmp(i, "weapon_hud_interface") == 0)
-        return TAG_CLASS_INT_WEAPON_HUD_INTERFACE;
-    else 
-        return TAG_CLASS_INT_NONE;
+    return tag_class_name_map.find(i);
 }
@@ -1,6 +1,7 @@
 #include "map_load.h"
 #include <vector>
 #include <stdint.h>
+#include <string.h>
 
 #include "tick.h"
 #include "../client_signature.h"
@@ -36,3 +37,62 @@ static void initialize_map_load() noexcept {
     static BasicCodecave on_map_load_bytecode;
     write_jmp_call(get_signature("on_map_load_sig").address(), nullptr, reinterpret_cast<void *>(on_map_load), on_map_load_bytecode);
 }
+
+static std::vector<Event<event_no_args>> preload_events;
+
+static void initialize_map_preload() noexcept;
+static bool map_preload_initialized = false;
+
+void add_map_preload_event(event_no_args event_function, EventPriority priority) noexcept {
+    for(size_t i=0;i<preload_events.size();i++) {
+        if(preload_events[i].function == event_function) return;
+    }
+    if(!map_preload_initialized) initialize_map_preload();
+    preload_events.emplace_back(event_function, priority);
+}
+
+void remove_map_preload_event(event_no_args event_function) noexcept {
+    for(size_t i=0;i<preload_events.size();i++) {
+        if(preload_events[i].function == event_function) {
+            preload_events.erase(preload_events.begin() + i);
+            return;
+        }
+    }
+}
+
+static void on_map_preload() noexcept {
+    call_in_order(preload_events);
+}
+
+static void initialize_map_preload() noexcept {
+    map_preload_initialized = true;
+
+    // The signature is the header check (cmp dword ptr [header], 'head'), which is moved into the codecave after the call.
+    auto *preload_addr = get_signature("on_map_preload_sig").address();
+    unsigned char code[] = {
+        // pushad
+        0x60,
+
+        // call on_map_preload
+        0xE8, 0xFF, 0xFF, 0xFF, 0xFF,
+
+        // popad
+        0x61,
+
+        // cmp dword ptr [header], 'head'
+        0x81, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0x64, 0x61, 0x65, 0x68,
+
+        // jmp back
+        0xE9, 0xFF, 0xFF, 0xFF, 0xFF
+    };
+    memcpy(code + 7, preload_addr, 10);
+
+    static BasicCodecave on_map_preload_code(code, sizeof(code));
+    write_code_any_value(on_map_preload_code.data + 1 + 1, reinterpret_cast<int>(on_map_preload) - reinterpret_cast<int>(on_map_preload_code.data + 1 + 5));
+    write_code_any_value(on_map_preload_code.data + 17 + 1, reinterpret_cast<int>(preload_addr + 10) - reinterpret_cast<int>(on_map_preload_code.data + 17 + 5));
+
+    static unsigned char nop10[10] = { 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90 };
+    write_code_c(preload_addr, nop10);
+    write_code_any_value(preload_addr, static_cast<unsigned char>(0xE9));
+    write_code_any_value(preload_addr + 1, reinterpret_cast<int>(on_map_preload_code.data) - reinterpret_cast<int>(preload_addr + 5));
+}
@@ -4,3 +4,7 @@
 
 void add_map_load_event(event_no_args event_function, EventPriority priority = EVENT_PRIORITY_DEFAULT) noexcept;
 void remove_map_load_event(event_no_args event_function) noexcept;
+
+/// Preload events are called once the header of a map being loaded has been read, before anything else in the map is.
+void add_map_preload_event(event_no_args event_function, EventPriority priority = EVENT_PRIORITY_DEFAULT) noexcept;
+void remove_map_preload_event(event_no_args event_function) noexcept;
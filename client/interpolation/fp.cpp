@@ -1,7 +1,9 @@
 #include <string.h>
+#include <vector>
 #include "fp.h"
 #include "../hooks/tick.h"
 #include "../halo_data/table.h"
+#include "../halo_data/tag_data.h"
 #include "../../math/data_types.h"
 
 struct FirstPersonNode {
@@ -10,10 +12,44 @@ struct FirstPersonNode {
     float unknown_1 = 1.0;
 };
 
+#define MAX_FP_NODES 128
+
 FirstPersonNode *fpn = reinterpret_cast<FirstPersonNode *>(0x40000EC0+0x8C);
 
-static FirstPersonNode fpbuffer0[128] = {};
-static FirstPersonNode fpbuffer1[128] = {};
+static FirstPersonNode fpbuffer0[MAX_FP_NODES] = {};
+static FirstPersonNode fpbuffer1[MAX_FP_NODES] = {};
+
+// Number of first person nodes used by each weapon tag (indexed by tag index), including the hands.
+static std::vector<uint8_t> weapon_fp_node_counts;
+static uint32_t hands_node_count = 0;
+static uint32_t fp_node_count = 0;
+
+static uint32_t model_node_count(const HaloTagID &model_id) noexcept {
+    if(!model_id.is_valid()) return 0;
+    return *reinterpret_cast<uint32_t *>(HaloTag::from_id(model_id).data + 0xB8);
+}
+
+void cache_fp_node_counts() noexcept {
+    auto tag_count = *reinterpret_cast<uint32_t *>(0x4044000C);
+    auto *tags = *reinterpret_cast<HaloTag **>(0x40440000);
+
+    hands_node_count = 0;
+    for(size_t i=0;i<tag_count;i++) {
+        if(tags[i].tag_class == 0x6D617467) {
+            auto &fp_interface_count = *reinterpret_cast<uint32_t *>(tags[i].data + 0x17C);
+            auto *&fp_interface = *reinterpret_cast<char **>(tags[i].data + 0x17C + 4);
+            if(fp_interface_count) hands_node_count = model_node_count(*reinterpret_cast<HaloTagID *>(fp_interface + 0xC));
+            break;
+        }
+    }
+
+    weapon_fp_node_counts.assign(tag_count, 0);
+    for(size_t i=0;i<tag_count;i++) {
+        if(tags[i].tag_class != 0x77656170) continue;
+        auto count = hands_node_count + model_node_count(*reinterpret_cast<HaloTagID *>(tags[i].data + 0x45C + 0xC));
+        weapon_fp_node_counts[i] = count > MAX_FP_NODES ? MAX_FP_NODES : count;
+    }
+}
 
 void fp_before() noexcept {
     extern float interpolation_tick_progress;
@@ -24,8 +60,6 @@ void fp_before() noexcept {
     if(tick_now != tick_before) {
         static uint32_t weapon_id = NULL_ID;
         tick_before = tick_now;
-        memcpy(fpbuffer1,fpbuffer0,sizeof(fpbuffer0));
-        memcpy(fpbuffer0,fpn,sizeof(fpbuffer0));
 
         HaloObject o(HaloPlayer().object_id());
         auto *odata = o.object_data();
@@ -34,19 +68,31 @@ void fp_before() noexcept {
         if(odata) current_id = *(reinterpret_cast<uint32_t *>(odata + 0x2F8) + *reinterpret_cast<uint16_t *>(odata + 0x2F2));
         else current_id = NULL_ID;
 
+        // Only copy and interpolate the nodes the current weapon and hands actually use. Fall back to all of them if
+        // the weapon tag is unknown (i.e. the cache is out of date).
+        fp_node_count = MAX_FP_NODES;
+        auto *weapon_data = HaloObject(current_id).object_data();
+        if(weapon_data) {
+            auto tag_index = reinterpret_cast<BaseHaloObject *>(weapon_data)->tag_id.index;
+            if(tag_index < weapon_fp_node_counts.size() && weapon_fp_node_counts[tag_index] != 0) fp_node_count = weapon_fp_node_counts[tag_index];
+        }
+
+        memcpy(fpbuffer1,fpbuffer0,sizeof(fpbuffer0[0]) * fp_node_count);
+        memcpy(fpbuffer0,fpn,sizeof(fpbuffer0[0]) * fp_node_count);
+
         skip = get_camera_type() != CAMERA_FIRST_PERSON || current_id != weapon_id;
         weapon_id = current_id;
     }
 
     if(skip) return;
 
-    for(int i=0;i<128;i++) {
-        interpolate_quat(fpbuffer1[i].rotation_stuff, fpbuffer0[i].rotation_stuff, fpn[i].rotation_stuff, interpolation_tick_progress);
+    interpolate_quat_batch(&fpbuffer1[0].rotation_stuff, &fpbuffer0[0].rotation_stuff, &fpn[0].rotation_stuff, fp_node_count, interpolation_tick_progress, sizeof(FirstPersonNode));
+    for(uint32_t i=0;i<fp_node_count;i++) {
         interpolate_vector(fpbuffer1[i].position, fpbuffer0[i].position, fpn[i].position, interpolation_tick_progress);
         fpn[i].unknown_1 = fpbuffer1[i].unknown_1 + (fpbuffer0[i].unknown_1 - fpbuffer1[i].unknown_1) * interpolation_tick_progress;
     }
 }
 
 void fp_after() noexcept {
-    memcpy(fpn,fpbuffer0,sizeof(fpbuffer0));
+    memcpy(fpn,fpbuffer0,sizeof(fpbuffer0[0]) * fp_node_count);
 }
@@ -2,3 +2,6 @@
 
 void fp_before() noexcept;
 void fp_after() noexcept;
+
+/// Cache the number of first person nodes used by each weapon tag in the current map.
+void cache_fp_node_counts() noexcept;
@@ -5,11 +5,14 @@
 #include "../client_signature.h"
 #include "../hooks/camera.h"
 #include "../hooks/frame.h"
+#include "../hooks/map_load.h"
 #include "../hooks/tick.h"
 #include "../halo_data/map.h"
+#include "../halo_data/object_changes.h"
 #include "../halo_data/tag_data.h"
 #include "../halo_data/server.h"
 #include "../halo_data/table.h"
+#include "../../math/quantize.h"
 #include "light.h"
 #include "interpolation.h"
 #include "particle.h"
@@ -42,11 +45,29 @@ struct BufferedObject {
     InterpolationType interpolation_type;
     Vector3D position;
     Vector3D position_center;
+    uint32_t node_count;
     ModelNode nodes[MAX_NODES];
 };
 
+// 16 bytes instead of 52
+struct QuantizedModelNode {
+    float scale;
+    QuantizedQuaternion48 rotation;
+    QuantizedVector3D position;
+};
+
+// The previous tick is only ever interpolated from, so it's kept quantized. The current tick has to stay as-is since
+// it's what objects get rolled back to.
+struct QuantizedBufferedObject {
+    uint32_t tag_id;
+    InterpolationType interpolation_type;
+    Vector3D position_center;
+    float node_position_scale;
+    QuantizedModelNode nodes[MAX_NODES];
+};
+
 static BufferedObject objects_buffer_0[2048];
-static BufferedObject objects_buffer_1[2048];
+static QuantizedBufferedObject objects_buffer_1[2048];
 
 const char ilevels[10][9] {
 //   B V W E G P S M C
@@ -76,6 +97,7 @@ const uint32_t model_node_offset[16] = {
 
 float interpolation_tick_progress = 0.0;
 extern interpolate_vector_fn interpolate_vector_objects;
+extern interpolate_floats_fn interpolate_floats_objects;
 
 static void do_interpolation(uint32_t i) noexcept {
     HaloObject o(i);
@@ -141,14 +163,20 @@ static void do_interpolation(uint32_t i) noexcept {
         if(objects_buffer_1[i].interpolation_type != INTERPOLATION_NONE)
             interpolate_vector_objects(objects_buffer_1[i].position_center, objects_buffer_0[i].position_center, position_center, interpolation_tick_progress);
 
+        objects_buffer_0[i].node_count = node_count;
+        auto &before_object = objects_buffer_1[i];
         for(uint32_t x=0;x<node_count;x++) {
             objects_buffer_0[i].nodes[x] = nodes[x];
-            if(objects_buffer_1[i].interpolation_type != INTERPOLATION_NONE) {
-                interpolate_vector_objects(objects_buffer_1[i].nodes[x].position, objects_buffer_0[i].nodes[x].position, nodes[x].position, interpolation_tick_progress);
-                nodes[x].scale = objects_buffer_1[i].nodes[x].scale + (objects_buffer_0[i].nodes[x].scale - objects_buffer_1[i].nodes[x].scale) * interpolation_tick_progress;
+            if(before_object.interpolation_type != INTERPOLATION_NONE) {
+                auto &before_node = before_object.nodes[x];
+                Vector3D before_position;
+                dequantize_position(before_node.position, before_object.position_center, before_object.node_position_scale, before_position);
+                interpolate_vector_objects(before_position, objects_buffer_0[i].nodes[x].position, nodes[x].position, interpolation_tick_progress);
+                nodes[x].scale = before_node.scale + (objects_buffer_0[i].nodes[x].scale - before_node.scale) * interpolation_tick_progress;
 
                 if(objects_buffer_0[i].interpolation_type == INTERPOLATION_POSITION_ROTATION) {
-                    Quaternion before = objects_buffer_1[i].nodes[x].rotation;
+                    Quaternion before;
+                    dequantize_quat(before_node.rotation, before);
                     Quaternion after = objects_buffer_0[i].nodes[x].rotation;
                     Quaternion out;
                     interpolate_quat(before,after,out,interpolation_tick_progress);
@@ -185,9 +213,38 @@ static void interpolate_objects() noexcept {
 }
 
 
+static void quantize_object(const BufferedObject &object, QuantizedBufferedObject &output) noexcept {
+    output.tag_id = object.tag_id;
+    output.interpolation_type = object.interpolation_type;
+    output.position_center = object.position_center;
+    if(object.interpolation_type == INTERPOLATION_NONE) return;
+
+    const auto &node_count = object.node_count;
+    output.node_position_scale = quantize_position_scale(&object.nodes[0].position, node_count, object.position_center, sizeof(ModelNode));
+    for(uint32_t x=0;x<node_count;x++) {
+        auto &node = object.nodes[x];
+        auto &quantized = output.nodes[x];
+        quantized.scale = node.scale;
+        quantized.rotation = quantize_quat_48(Quaternion(node.rotation));
+        quantized.position = quantize_position(node.position, object.position_center, output.node_position_scale);
+    }
+}
+
 static void reset() noexcept {
     extern float stored_zoom_scale;
-    memcpy(objects_buffer_1,objects_buffer_0,sizeof(objects_buffer_0));
+    for(uint32_t i=0;i<2048;i++) {
+        quantize_object(objects_buffer_0[i], objects_buffer_1[i]);
+    }
+
+    // An object that replaced another one in the same slot this tick has nothing to be interpolated from, even if it
+    // has the same tag.
+    auto &changes = object_changes();
+    for(auto id : changes.spawned) {
+        objects_buffer_1[id & 0xFFFF].interpolation_type = INTERPOLATION_NONE;
+    }
+    for(auto id : changes.tag_changed) {
+        objects_buffer_1[id & 0xFFFF].interpolation_type = INTERPOLATION_NONE;
+    }
     buffer_widgets();
     stored_zoom_scale = 0;
     nuked = true;
@@ -281,6 +338,7 @@ ChimeraCommandError interpolate_command(size_t argc, const char **argv) noexcept
             remove_camera_event(interpolate_all_cam_after);
             remove_preframe_event(interpolate_objects);
             remove_frame_event(rollback_interpolation);
+            remove_map_load_event(cache_fp_node_counts);
             initialized = false;
         }
         else if(!initialized && new_setting != 0) {
@@ -301,6 +359,8 @@ ChimeraCommandError interpolate_command(size_t argc, const char **argv) noexcept
             add_camera_event(interpolate_all_cam_after);
             add_preframe_event(interpolate_objects);
             add_frame_event(rollback_interpolation);
+            add_map_load_event(cache_fp_node_counts);
+            cache_fp_node_counts();
 
             size_t offset = camera_change_s.size();
             static BasicCodecave on_camera_change_code(camera_change_s.signature(), offset);
@@ -356,10 +416,12 @@ ChimeraCommandError interpolate_predict_command(size_t argc, const char **argv)
             switch(new_value) {
                 case 0:
                     interpolate_vector_objects = interpolate_vector;
+                    interpolate_floats_objects = interpolate_floats;
                     break;
                 case 1:
                 case 2:
                     interpolate_vector_objects = interpolate_vector_predict;
+                    interpolate_floats_objects = interpolate_floats_predict;
                     break;
                 default: {
                     console_out_error("Expected a value between 0 and 2.");
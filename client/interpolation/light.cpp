@@ -1,5 +1,6 @@
 #include "light.h"
 
+#include <math.h>
 #include <string.h>
 #include "../../math/data_types.h"
 #include "camera.h"
@@ -31,44 +32,105 @@ struct Light {
 
 #define MAX_LIGHTS 0x380
 
-struct MiniLight {
-    Vector3D position;
-    Vector3D rotation[2];
-    uint32_t some_counter;
-    bool valid;
+struct LightBuffer {
+    uint32_t some_counter[MAX_LIGHTS];
+    bool valid[MAX_LIGHTS];
+    Vector3D position[MAX_LIGHTS];
+    Vector3D rotation[MAX_LIGHTS][2];
 };
 
-static MiniLight light_buffer_0[MAX_LIGHTS] = {};
-static MiniLight light_buffer_1[MAX_LIGHTS] = {};
+static LightBuffer light_buffers[2] = {};
+
+// These are swapped every tick rather than copied.
+static LightBuffer *light_buffer_0 = light_buffers;
+static LightBuffer *light_buffer_1 = light_buffers + 1;
+
+// Lights that are valid in both buffers are packed here so the per-frame loop only touches lights that changed.
+static uint16_t active_lights[MAX_LIGHTS];
+static size_t active_light_count = 0;
+
+static float rotation_before[2][3][MAX_LIGHTS];
+static float rotation_after[2][3][MAX_LIGHTS];
+static float rotation_radius[2][MAX_LIGHTS];
+static float rotation_output[2][3][MAX_LIGHTS];
+
+static Vector3DSoA rotation_soa(float (&rotation)[3][MAX_LIGHTS]) noexcept {
+    return Vector3DSoA { rotation[0], rotation[1], rotation[2] };
+}
 
 void light_before() noexcept {
     extern float interpolation_tick_progress;
     extern size_t chimera_interpolate_setting;
     static int32_t tick_before = 0;
+    static size_t light_count = 0;
     auto tick_now = tick_count();
     auto &light_table = get_light_table();
     auto *lights = reinterpret_cast<Light *>(light_table.first);
 
     if(tick_now != tick_before) {
         tick_before = tick_now;
-        memcpy(light_buffer_1, light_buffer_0, sizeof(light_buffer_0));
+        auto *swap = light_buffer_1;
+        light_buffer_1 = light_buffer_0;
+        light_buffer_0 = swap;
+
+        // Anything past the end of the table this tick was not written last tick, either.
+        size_t previous_light_count = light_count;
+        light_count = light_table.size;
+        if(light_count > MAX_LIGHTS) light_count = MAX_LIGHTS;
+        for(size_t i=light_count;i<previous_light_count;i++) {
+            light_buffer_0->some_counter[i] = 0;
+            light_buffer_0->valid[i] = false;
+        }
+
+        bool cull = chimera_interpolate_setting < 9;
         auto &p = camera_data().position;
-        for(size_t i=0;i<MAX_LIGHTS;i++) {
-            light_buffer_0[i].some_counter = lights[i].some_counter;
-            light_buffer_0[i].valid = light_buffer_0[i].some_counter > light_buffer_1[i].some_counter;
-            if(light_buffer_0[i].valid && chimera_interpolate_setting < 9) {
-                light_buffer_0[i].valid = distance(p, light_buffer_0[i].position) / zoom_scale() < 20;
+        float max_distance = 20 * zoom_scale();
+        float max_distance_squared = max_distance * max_distance;
+
+        active_light_count = 0;
+        for(size_t i=0;i<light_count;i++) {
+            auto &light = lights[i];
+            auto &valid = light_buffer_0->valid[i];
+            light_buffer_0->some_counter[i] = light.some_counter;
+            valid = light.some_counter > light_buffer_1->some_counter[i];
+            if(valid && cull) {
+                valid = distance_squared(p, light.position) < max_distance_squared;
             }
-            if(light_buffer_0[i].valid) {
-                light_buffer_0[i].position = lights[i].position;
-                memcpy(light_buffer_0[i].rotation, lights[i].rotation, sizeof(light_buffer_0[i].rotation));
+            if(!valid) continue;
+
+            light_buffer_0->position[i] = light.position;
+            light_buffer_0->rotation[i][0] = light.rotation[0];
+            light_buffer_0->rotation[i][1] = light.rotation[1];
+            if(!light_buffer_1->valid[i]) continue;
+
+            auto a = active_light_count++;
+            active_lights[a] = i;
+            for(int x=0;x<2;x++) {
+                auto &before = light_buffer_1->rotation[i][x];
+                auto &after = light_buffer_0->rotation[i][x];
+                rotation_before[x][0][a] = before.x;
+                rotation_before[x][1][a] = before.y;
+                rotation_before[x][2][a] = before.z;
+                rotation_after[x][0][a] = after.x;
+                rotation_after[x][1][a] = after.y;
+                rotation_after[x][2][a] = after.z;
+                rotation_radius[x][a] = sqrt(before.x * before.x + before.y * before.y + before.z * before.z);
             }
         }
     }
 
-    for(size_t i=0;i<MAX_LIGHTS;i++) {
-        if(light_buffer_0[i].valid != true || light_buffer_1[i].valid != true) continue;
-        for(int x=0;x<2;x++) interpolate_vector_rotation(light_buffer_1[i].rotation[x], light_buffer_0[i].rotation[x], lights[i].rotation[x], interpolation_tick_progress);
-        interpolate_vector(light_buffer_1[i].position, light_buffer_0[i].position, lights[i].position, interpolation_tick_progress);
+    for(int x=0;x<2;x++) {
+        interpolate_vector_rotation_soa(rotation_soa(rotation_before[x]), rotation_soa(rotation_after[x]), rotation_radius[x], rotation_soa(rotation_output[x]), active_light_count, interpolation_tick_progress);
+    }
+
+    for(size_t a=0;a<active_light_count;a++) {
+        auto i = active_lights[a];
+        auto &light = lights[i];
+        for(int x=0;x<2;x++) {
+            light.rotation[x].x = rotation_output[x][0][a];
+            light.rotation[x].y = rotation_output[x][1][a];
+            light.rotation[x].z = rotation_output[x][2][a];
+        }
+        interpolate_vector(light_buffer_1->position[i], light_buffer_0->position[i], light.position, interpolation_tick_progress);
     }
 }
@@ -1,5 +1,6 @@
 #include <math.h>
 #include <string.h>
+#include <vector>
 #include "../halo_data/table.h"
 #include "../hooks/tick.h"
 #include "../../math/data_types.h"
@@ -46,58 +47,70 @@ struct Particle {
     float blue;
 };
 
-static InterParticle particles_buffer_0[1024] = {};
-static InterParticle particles_buffer_1[1024] = {};
+// These are sized to the particle table's max_count.
+static std::vector<InterParticle> particles_buffer_0;
+static std::vector<InterParticle> particles_buffer_1;
 
 // This is used to verify that a particle hasn't been changed.
-static InterParticle particles_buffer_intermediate[1024] = {};
+static std::vector<InterParticle> particles_buffer_intermediate;
 
-static int32_t particles_count = 0;
+static size_t particles_count = 0;
+
+static void resize_particle_buffers(size_t max_count) noexcept {
+    if(particles_buffer_0.size() == max_count) return;
+    particles_buffer_0.assign(max_count, InterParticle());
+    particles_buffer_1.assign(max_count, InterParticle());
+    particles_buffer_intermediate.assign(max_count, InterParticle());
+    particles_count = 0;
+}
 
 void do_particle_interpolation() noexcept {
     static int32_t tick_before = 0;
     auto tick_now = tick_count();
 
-    auto &particle_table = get_particle_table();
+    TableView<Particle> particles(get_particle_table());
+    resize_particle_buffers(particles.max_count());
     if(tick_before != tick_now) {
         tick_before = tick_now;
-        particles_count = particle_table.size;
-        if(particles_count > 1024) particles_count = 1024;
-        auto *live_particles = reinterpret_cast<Particle *>(particle_table.first);
-        memset(particles_buffer_0,0,sizeof(particles_buffer_0));
-        for(uint32_t i=0;i<1024;i++) {
-            particles_buffer_0[i].position = live_particles[i].position;
-            if((live_particles[i].unknown0 & 0xFFFF) != 0) {
-                if(distance_squared(particles_buffer_0[i].position, particles_buffer_1[i].position) > 0.45) continue;
-                if(live_particles[i].position.x != particles_buffer_intermediate[i].position.x ||
-                live_particles[i].position.y != particles_buffer_intermediate[i].position.y ||
-                live_particles[i].position.z != particles_buffer_intermediate[i].position.z) continue;
-                particles_buffer_0[i].valid = true;
-            }
+        particles_count = particles.size();
+        for(size_t i=0;i<particles_count;i++) {
+            particles_buffer_0[i].valid = false;
+        }
+        for(auto particle = particles.begin(); particle != particles.end(); ++particle) {
+            auto i = particle.index();
+            particles_buffer_0[i].position = particle->position;
+            if(distance_squared(particles_buffer_0[i].position, particles_buffer_1[i].position) > 0.45) continue;
+            if(particle->position.x != particles_buffer_intermediate[i].position.x ||
+            particle->position.y != particles_buffer_intermediate[i].position.y ||
+            particle->position.z != particles_buffer_intermediate[i].position.z) continue;
+            particles_buffer_0[i].valid = true;
         }
     }
-    auto *live_particles = reinterpret_cast<Particle *>(particle_table.first);
-    for(uint32_t i=0;i<1024;i++) {
+    for(size_t i=0;i<particles_count;i++) {
         if(!particles_buffer_0[i].valid || !particles_buffer_1[i].valid) continue;
         extern float interpolation_tick_progress;
-        interpolate_vector(particles_buffer_1[i].position, particles_buffer_0[i].position, live_particles[i].position, interpolation_tick_progress);
+        interpolate_vector(particles_buffer_1[i].position, particles_buffer_0[i].position, particles.at(i)->position, interpolation_tick_progress);
     }
 }
 
 void on_particle_physics_before() noexcept {
-    auto &particle_table = get_particle_table();
-    auto *live_particles = reinterpret_cast<Particle *>(particle_table.first);
-    for(uint32_t i=0;i<1024;i++) {
+    TableView<Particle> particles(get_particle_table());
+    resize_particle_buffers(particles.max_count());
+    for(size_t i=0;i<particles_count;i++) {
         if(!particles_buffer_0[i].valid) continue;
-        live_particles[i].position = particles_buffer_0[i].position;
+        particles.at(i)->position = particles_buffer_0[i].position;
+    }
+
+    // Nothing past particles_count is valid in either buffer, so only that much needs to be carried over.
+    for(size_t i=0;i<particles_buffer_1.size();i++) {
+        particles_buffer_1[i] = i < particles_count ? particles_buffer_0[i] : InterParticle();
     }
-    memcpy(particles_buffer_1,particles_buffer_0,sizeof(particles_buffer_0));
 }
 
 void on_particle_physics_after() noexcept {
-    auto &particle_table = get_particle_table();
-    auto *live_particles = reinterpret_cast<Particle *>(particle_table.first);
-    for(uint32_t i=0;i<1024;i++) {
-        particles_buffer_intermediate[i].position = live_particles[i].position;
+    TableView<Particle> particles(get_particle_table());
+    resize_particle_buffers(particles.max_count());
+    for(auto particle = particles.begin(); particle != particles.end(); ++particle) {
+        particles_buffer_intermediate[particle.index()].position = particle->position;
     }
 }
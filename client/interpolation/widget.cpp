@@ -1,5 +1,6 @@
 #include <math.h>
 #include <string.h>
+#include <vector>
 #include "../../math/data_types.h"
 #include "../halo_data/table.h"
 #include "widget.h"
@@ -37,58 +38,91 @@ struct Flag {
     char padding[8];
 };
 
-#define MAX_ANTENNA 0xC
-static Antenna antenna_buffer_0[MAX_ANTENNA] = {};
-static Antenna antenna_buffer_1[MAX_ANTENNA] = {};
+// Both tables are sized by the game, so the buffers are sized from the tables' max_count rather than hardcoded.
+struct WidgetBuffer {
+    std::vector<Antenna> antennas;
+    size_t antenna_count = 0;
+    std::vector<Flag> flags;
+    size_t flag_count = 0;
+};
+
+static WidgetBuffer widget_buffers[2];
 
-#define MAX_FLAG 0x2
-static Flag flag_buffer_0[MAX_FLAG] = {};
-static Flag flag_buffer_1[MAX_FLAG] = {};
+// These are swapped every tick rather than copied.
+static WidgetBuffer *widget_buffer_0 = widget_buffers;
+static WidgetBuffer *widget_buffer_1 = widget_buffers + 1;
+static bool widget_buffer_0_filled = false;
 
 extern float interpolation_tick_progress;
+extern interpolate_floats_fn interpolate_floats_objects;
 
 static bool rollback_flag = false;
 
 void do_antenna_interpolation() noexcept {
     static auto *ant = reinterpret_cast<Antenna *>(get_antenna_table().first);
-    for(uint32_t i=0;i<MAX_ANTENNA;i++) {
+    auto &antenna_buffer_0 = widget_buffer_0->antennas;
+    auto &antenna_buffer_1 = widget_buffer_1->antennas;
+    auto count = widget_buffer_0->antenna_count < widget_buffer_1->antenna_count ? widget_buffer_0->antenna_count : widget_buffer_1->antenna_count;
+    for(uint32_t i=0;i<count;i++) {
         if(distance_squared(antenna_buffer_1[i].position, antenna_buffer_0[i].position) > 1) continue;
         for(uint32_t j=0;j<21;j++) {
             interpolate_vector_objects(antenna_buffer_1[i].vertices[j].position, antenna_buffer_0[i].vertices[j].position, ant[i].vertices[j].position, interpolation_tick_progress);
         }
     }
 }
+
 void do_flag_interpolation() noexcept {
     static auto *flag = reinterpret_cast<Flag *>(get_flag_table().first);
+    auto &flag_buffer_0 = widget_buffer_0->flags;
+    auto &flag_buffer_1 = widget_buffer_1->flags;
+    auto count = widget_buffer_0->flag_count < widget_buffer_1->flag_count ? widget_buffer_0->flag_count : widget_buffer_1->flag_count;
     rollback_flag = false;
-    for(int i=0;i<MAX_FLAG;i++) {
+    for(size_t i=0;i<count;i++) {
         HaloObject o(flag[i].parent_object_id);
         char *odata = o.object_data();
         if(odata && odata[0xB4] == 2) {
             if(distance_squared(flag_buffer_0[i].position, flag_buffer_1[i].position) > 4) continue;
             interpolate_vector_objects(flag_buffer_1[i].position, flag_buffer_0[i].position, flag[i].position, interpolation_tick_progress);
             rollback_flag = true;
-            for(uint32_t j=0;j<sizeof(flag_buffer_1[i].parts) / sizeof(flag_buffer_1[i].parts[0]);j++) {
-                interpolate_vector_objects(flag_buffer_1[i].parts[j].position, flag_buffer_0[i].parts[j].position, flag[i].parts[j].position, interpolation_tick_progress);
-            }
+
+            // FlagPart is nothing but floats, so the whole cloth mesh (velocity included) can be done in one pass. The
+            // velocities are restored in rollback_widget_interpolation along with the positions.
+            interpolate_floats_objects(reinterpret_cast<const float *>(flag_buffer_1[i].parts), reinterpret_cast<const float *>(flag_buffer_0[i].parts), reinterpret_cast<float *>(flag[i].parts), sizeof(flag[i].parts) / (sizeof(float)), interpolation_tick_progress);
         }
     }
 }
+
 void buffer_widgets() noexcept {
-    memcpy(antenna_buffer_1,antenna_buffer_0,sizeof(antenna_buffer_0));
-    memcpy(flag_buffer_1,flag_buffer_0,sizeof(flag_buffer_1));
+    // If no frame was drawn since the last tick, buffer 0 still holds stale data, so keep buffer 1 as it is.
+    if(!widget_buffer_0_filled) return;
+    widget_buffer_0_filled = false;
+    auto *swap = widget_buffer_1;
+    widget_buffer_1 = widget_buffer_0;
+    widget_buffer_0 = swap;
 }
+
 void buffer_widgets_l() noexcept {
-    memcpy(antenna_buffer_0,get_antenna_table().first,sizeof(antenna_buffer_0));
-    memcpy(flag_buffer_0,get_flag_table().first,sizeof(flag_buffer_0));
+    auto &antenna_table = get_antenna_table();
+    auto &antennas = widget_buffer_0->antennas;
+    if(antennas.size() != antenna_table.max_count) antennas.resize(antenna_table.max_count);
+    widget_buffer_0->antenna_count = TableView<Antenna>(antenna_table).size();
+    memcpy(antennas.data(), antenna_table.first, widget_buffer_0->antenna_count * sizeof(Antenna));
+
+    auto &flag_table = get_flag_table();
+    auto &flags = widget_buffer_0->flags;
+    if(flags.size() != flag_table.max_count) flags.resize(flag_table.max_count);
+    widget_buffer_0->flag_count = TableView<Flag>(flag_table).size();
+    memcpy(flags.data(), flag_table.first, widget_buffer_0->flag_count * sizeof(Flag));
+
+    widget_buffer_0_filled = true;
 }
 
 void rollback_widget_interpolation() noexcept {
+    if(!rollback_flag) return;
     static auto *flag = reinterpret_cast<Flag *>(get_flag_table().first);
-    for(int i=0;i<MAX_FLAG;i++) {
+    auto &flag_buffer_0 = widget_buffer_0->flags;
+    for(size_t i=0;i<widget_buffer_0->flag_count;i++) {
         flag[i].position = flag_buffer_0[i].position;
-        for(uint32_t j=0;j<sizeof(flag_buffer_1[i].parts) / sizeof(flag_buffer_1[i].parts[0]);j++) {
-            flag[i].parts[j].position = flag_buffer_0[i].parts[j].position;
-        }
+        memcpy(flag[i].parts, flag_buffer_0[i].parts, sizeof(flag[i].parts));
     }
 }
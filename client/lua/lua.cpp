@@ -2,6 +2,7 @@
 #include <memory>
 #include <windows.h>
 #include <math.h>
+#include "lua_cache.h"
 #include "lua_callback.h"
 #include "lua_game.h"
 #include "lua_io.h"
@@ -126,11 +127,13 @@ static void load_lua_script(const char *script_name, const char *lua_script_data
 
     scripts.push_back(std::make_unique<LuaScript>(state, script_name, global, unlocked));
 
-    if(luaL_loadbuffer(state, lua_script_data, lua_script_data_size, script_name) != LUA_OK || lua_pcall(state, 0, 0, 0) != LUA_OK) {
+    if(load_cached_chunk(state, script_name, lua_script_data, lua_script_data_size, global) != LUA_OK || lua_pcall(state, 0, 0, 0) != LUA_OK) {
         console_out_error(std::string("Failed to load ") + script_name + ".");
         print_error(state);
-        lua_close(state);
+
+        // The script may have set callbacks before failing, so it has to be destroyed while its state still exists.
         scripts.erase(scripts.begin() + scripts.size() - 1);
+        lua_close(state);
         return;
     }
 
@@ -189,6 +192,8 @@ static void setup_lua_folder() {
     CreateDirectory(z, nullptr);
     sprintf(z,"%s\\chimera\\lua\\global", halo_path());
     CreateDirectory(z, nullptr);
+    sprintf(z,"%s\\chimera\\lua\\cache", halo_path());
+    CreateDirectory(z, nullptr);
 }
 
 static void open_lua_scripts() {
@@ -229,11 +234,9 @@ void destroy_lua() {
 }
 
 LuaScript &script_from_state(lua_State *state) noexcept {
-    for(size_t i=0;i<scripts.size();i++) {
-        auto &s = *scripts[i].get();
-        if(s.state == state) return s;
-    }
-    std::terminate();
+    // The script is stored in the state's extra space when it's created. Lua copies it into any threads the script
+    // creates, so this works in coroutines, too.
+    return **static_cast<LuaScript **>(lua_getextraspace(state));
 }
 
 void print_error(lua_State *state) noexcept {
@@ -241,16 +244,23 @@ void print_error(lua_State *state) noexcept {
     lua_pop(state, 1);
 }
 
-LuaScript::LuaScript(lua_State *state, const char *name, const bool &global, const bool &unlocked) noexcept : state(state), name(name), unlocked(unlocked), global(global) {}
+LuaScript::LuaScript(lua_State *state, const char *name, const bool &global, const bool &unlocked) noexcept : state(state), name(name), unlocked(unlocked), global(global) {
+    *static_cast<LuaScript **>(lua_getextraspace(state)) = this;
+}
 
 LuaScript::~LuaScript() noexcept {
+    // Unsubscribe after calling unload, since unload can set callbacks, too.
     if(this->loaded) {
-        lua_getglobal(this->state, this->c_unload.callback_function.data());
+        push_callback_function(*this, this->c_unload);
         if(!lua_isnil(this->state, -1) && lua_pcall(this->state, 0, 0, 0) != LUA_OK) {
             print_error(this->state);
         }
+    }
+    unsubscribe_script(*this);
+    if(this->loaded) {
         lua_close(this->state);
     }
+    unschedule_timers(*this);
 }
 
 ChimeraCommandError reload_lua_command(size_t argc, const char **argv) noexcept {
@@ -259,48 +269,3 @@ ChimeraCommandError reload_lua_command(size_t argc, const char **argv) noexcept
     console_out("Scripts were reloaded.");
     return CHIMERA_COMMAND_ERROR_SUCCESS;
 }
-
-LuaAmbiguousTypeArgument LuaAmbiguousTypeArgument::check_argument(LuaScript &script, int arg, bool do_lua_error) {
-    LuaAmbiguousTypeArgument argument;
-    if(script.version < 2.03) { // BC
-        argument.argument_type = LuaAmbiguousTypeArgument::ARGUMENT_STRING;
-        argument.string_value = luaL_checkstring(script.state, arg);
-    }
-    else if(lua_isboolean(script.state, arg)) {
-        argument.argument_type = LuaAmbiguousTypeArgument::ARGUMENT_BOOLEAN;
-        argument.bool_value = lua_toboolean(script.state, arg);
-    }
-    else if(lua_isstring(script.state, arg)) {
-        argument.argument_type = LuaAmbiguousTypeArgument::ARGUMENT_STRING;
-        argument.string_value = lua_tostring(script.state, arg);
-    }
-    else if(lua_isnumber(script.state, arg)) {
-        argument.argument_type = LuaAmbiguousTypeArgument::ARGUMENT_NUMBER;
-        argument.number_value = lua_tonumber(script.state, arg);
-    }
-    else if(lua_isnil(script.state, arg)) {
-        argument.argument_type = LuaAmbiguousTypeArgument::ARGUMENT_NIL;
-    }
-    else {
-        if(do_lua_error) luaL_error(script.state, "timer argument must be boolean, string, number, or nil");
-        else throw std::exception();
-    }
-    return argument;
-}
-
-void LuaAmbiguousTypeArgument::push_argument(LuaScript &script) noexcept {
-    switch(this->argument_type) {
-        case LuaAmbiguousTypeArgument::ARGUMENT_BOOLEAN:
-            lua_pushboolean(script.state, this->bool_value);
-            break;
-        case LuaAmbiguousTypeArgument::ARGUMENT_STRING:
-            lua_pushstring(script.state, this->string_value.data());
-            break;
-        case LuaAmbiguousTypeArgument::ARGUMENT_NUMBER:
-            lua_pushnumber(script.state, this->number_value);
-            break;
-        case LuaAmbiguousTypeArgument::ARGUMENT_NIL:
-            lua_pushnil(script.state);
-            break;
-    }
-}
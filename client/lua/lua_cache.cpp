@@ -0,0 +1,105 @@
+#include "lua_cache.h"
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../path.h"
+#include "../../version.h"
+
+#define LUA_CACHE_MAGIC "CLBC"
+
+struct LuaCacheHeader {
+    char magic[4];
+    uint32_t lua_version;
+    uint32_t build_number;
+    uint32_t source_size;
+    double interpreter_version;
+
+    /// Hash of the chunk name and the source
+    uint64_t source_hash;
+
+    uint32_t bytecode_size;
+    uint32_t padding;
+};
+
+// FNV-1a
+static uint64_t hash_bytes(uint64_t hash, const char *data, size_t size) noexcept {
+    for(size_t i=0;i<size;i++) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+static void make_header(LuaCacheHeader &header, const char *script_name, const char *data, size_t size) noexcept {
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LUA_CACHE_MAGIC, sizeof(header.magic));
+    header.lua_version = LUA_VERSION_NUM;
+    header.build_number = CHIMERA_BUILD_NUMBER;
+    header.source_size = static_cast<uint32_t>(size);
+    header.interpreter_version = CHIMERA_LUA_INTERPRETER;
+
+    // The chunk name is saved in the bytecode, so it's part of the key, too.
+    auto hash = hash_bytes(0xCBF29CE484222325ull, script_name, strlen(script_name) + 1);
+    header.source_hash = hash_bytes(hash, data, size);
+}
+
+static bool headers_match(const LuaCacheHeader &a, const LuaCacheHeader &b) noexcept {
+    return memcmp(a.magic, b.magic, sizeof(a.magic)) == 0 && a.lua_version == b.lua_version && a.build_number == b.build_number && a.source_size == b.source_size && a.interpreter_version == b.interpreter_version && a.source_hash == b.source_hash;
+}
+
+static int write_bytecode(lua_State *, const void *data, size_t size, void *user) noexcept {
+    auto &bytecode = *reinterpret_cast<std::vector<char> *>(user);
+    auto *bytes = reinterpret_cast<const char *>(data);
+    bytecode.insert(bytecode.end(), bytes, bytes + size);
+    return 0;
+}
+
+int load_cached_chunk(lua_State *state, const char *script_name, const char *data, size_t size, bool global) noexcept {
+    // Precompiled scripts have nothing to gain from the cache.
+    if(size >= 1 && data[0] == LUA_SIGNATURE[0]) {
+        return luaL_loadbuffer(state, data, size, script_name);
+    }
+
+    auto path = std::string(halo_path()) + "\\chimera\\lua\\cache\\" + (global ? "global_" : "map_") + script_name + ".luac";
+    LuaCacheHeader header;
+    make_header(header, script_name, data, size);
+
+    FILE *f = fopen(path.data(), "rb");
+    if(f) {
+        LuaCacheHeader cached;
+        bool loaded = false;
+        if(fread(&cached, sizeof(cached), 1, f) == 1 && headers_match(header, cached)) {
+            auto bytecode = std::make_unique<char[]>(cached.bytecode_size);
+            if(fread(bytecode.get(), cached.bytecode_size, 1, f) == 1) {
+                // If the bytecode is somehow bad, just compile the source.
+                loaded = luaL_loadbufferx(state, bytecode.get(), cached.bytecode_size, script_name, "b") == LUA_OK;
+                if(!loaded) lua_pop(state, 1);
+            }
+        }
+        fclose(f);
+        if(loaded) return LUA_OK;
+    }
+
+    int result = luaL_loadbuffer(state, data, size, script_name);
+    if(result != LUA_OK) return result;
+
+    // Debug information is kept so errors still have line numbers.
+    std::vector<char> bytecode;
+    if(lua_dump(state, write_bytecode, &bytecode, 0) != 0) return result;
+    header.bytecode_size = static_cast<uint32_t>(bytecode.size());
+    // Lua doesn't verify bytecode, so write it somewhere else first. A crash or a full disk then can't leave a matching
+    // header in front of broken bytecode.
+    auto temp_path = path + ".tmp";
+    f = fopen(temp_path.data(), "wb");
+    if(f) {
+        bool written = fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(bytecode.data(), bytecode.size(), 1, f) == 1;
+        written = fclose(f) == 0 && written;
+        if(!written || !MoveFileExA(temp_path.data(), path.data(), MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileA(temp_path.data());
+        }
+    }
+    return result;
+}
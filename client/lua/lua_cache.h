@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stddef.h>
+#include "lua_script.h"
+
+/// Load a script's chunk onto the state's stack like luaL_loadbuffer. If the cache in chimera\lua\cache has bytecode
+/// compiled from the same source by the same version of Chimera, that is loaded instead of compiling the source again.
+/// Otherwise, the source is compiled and the cache is updated. Each script has one cache file, named after it.
+int load_cached_chunk(lua_State *state, const char *script_name, const char *data, size_t size, bool global) noexcept;
@@ -1,8 +1,9 @@
 #include "lua_callback.h"
 
+#include <algorithm>
 #include <memory>
 
-static LARGE_INTEGER last_time;
+static LARGE_INTEGER timer_epoch;
 
 #include "../messaging/messaging.h"
 #include "../hooks/camera.h"
@@ -23,69 +24,235 @@ int pcall(lua_State *state, int args, int result_count) noexcept {
     return x;
 }
 
+// Subscribers
+//
+// Each callback keeps a list of the scripts that set it, one per priority, in the order the scripts were loaded. This
+// way, dispatching a callback only touches scripts that actually use it.
+//
+// Scripts can set callbacks from inside a callback, so the lists can't be reshuffled while one is being dispatched.
+// Until every dispatch of the callback is done, unsubscribed scripts are left in their list as nullptr, and newly
+// subscribed scripts wait in pending.
+struct CallbackSubscribers {
+    LuaScriptCallback LuaScript::*callback;
+    std::vector<LuaScript *> scripts[EVENT_PRIORITY_FINAL + 1];
+    std::vector<LuaScript *> pending;
+    size_t dispatching = 0;
+};
+
+static CallbackSubscribers subscribers[] = {
+    { &LuaScript::c_command },
+    { &LuaScript::c_frame },
+    { &LuaScript::c_preframe },
+    { &LuaScript::c_map_load },
+    { &LuaScript::c_map_preload },
+    { &LuaScript::c_precamera },
+    { &LuaScript::c_rcon_message },
+    { &LuaScript::c_spawn },
+    { &LuaScript::c_prespawn },
+    { &LuaScript::c_tick },
+    { &LuaScript::c_pretick },
+    { &LuaScript::c_unload }
+};
+
+static CallbackSubscribers &subscribers_for(LuaScriptCallback LuaScript::*callback) noexcept {
+    for(auto &s : subscribers) {
+        if(s.callback == callback) return s;
+    }
+    std::terminate();
+}
+
+// Remove a script from a callback's subscribers. state is the thread making the change, which may be one of the
+// script's coroutines rather than script.state.
+static void unsubscribe(lua_State *state, LuaScript &script, LuaScriptCallback LuaScript::*callback) noexcept {
+    auto &callback_subscribers = subscribers_for(callback);
+    for(auto &list : callback_subscribers.scripts) {
+        auto found = std::find(list.begin(), list.end(), &script);
+        if(found == list.end()) continue;
+        if(callback_subscribers.dispatching) *found = nullptr;
+        else list.erase(found);
+    }
+    auto &pending = callback_subscribers.pending;
+    pending.erase(std::remove(pending.begin(), pending.end(), &script), pending.end());
+
+    auto &script_callback = script.*callback;
+    if(script_callback.function_ref != LUA_NOREF) {
+        luaL_unref(state, LUA_REGISTRYINDEX, script_callback.function_ref);
+        script_callback.function_ref = LUA_NOREF;
+    }
+}
+
+// Get the position of a script in the load order.
+static size_t script_order(const LuaScript *script) noexcept {
+    for(size_t i=0;i<scripts.size();i++) {
+        if(scripts[i].get() == script) return i;
+    }
+    return scripts.size();
+}
+
+static void subscribe(LuaScript &script, LuaScriptCallback LuaScript::*callback) noexcept {
+    auto &script_callback = script.*callback;
+    if(script_callback.callback_function == "" && script_callback.function_ref == LUA_NOREF) return;
+
+    auto &callback_subscribers = subscribers_for(callback);
+    if(callback_subscribers.dispatching) {
+        callback_subscribers.pending.push_back(&script);
+        return;
+    }
+
+    auto &list = callback_subscribers.scripts[script_callback.priority];
+    auto order = script_order(&script);
+    size_t i = 0;
+    while(i < list.size() && script_order(list[i]) < order) i++;
+    list.insert(list.begin() + i, &script);
+}
+
+void unsubscribe_script(LuaScript &script) noexcept {
+    for(auto &s : subscribers) {
+        unsubscribe(script.state, script, s.callback);
+    }
+}
+
+void push_callback_function(LuaScript &script, LuaScriptCallback &callback) noexcept {
+    if(callback.function_ref != LUA_NOREF) {
+        lua_rawgeti(script.state, LUA_REGISTRYINDEX, callback.function_ref);
+    }
+    else {
+        lua_getglobal(script.state, callback.callback_function.data());
+    }
+}
+
+// Call function for each script subscribed to callback at priority with the callback's function on top of its stack.
+// Scripts that unsubscribe while this is running are skipped, and scripts that subscribe aren't called until their
+// subscription is added after every dispatch of the callback is done.
+template<typename F>
+static void for_each_subscriber(LuaScriptCallback LuaScript::*callback, EventPriority priority, F function) noexcept {
+    auto &callback_subscribers = subscribers_for(callback);
+    auto &list = callback_subscribers.scripts[priority];
+    if(list.empty()) return;
+
+    callback_subscribers.dispatching++;
+    for(size_t i=0;i<list.size();i++) {
+        auto *script = list[i];
+        if(!script) continue;
+        push_callback_function(*script, script->*callback);
+        if(!function(*script)) break;
+    }
+    if(--callback_subscribers.dispatching) return;
+
+    for(auto &l : callback_subscribers.scripts) {
+        l.erase(std::remove(l.begin(), l.end(), nullptr), l.end());
+    }
+    std::vector<LuaScript *> pending;
+    pending.swap(callback_subscribers.pending);
+    for(auto *script : pending) {
+        subscribe(*script, callback);
+    }
+}
+
 #define basic_callback(callback) [](EventPriority priority) noexcept {\
-    for(size_t i=0;i<scripts.size();i++) {\
-        auto &script = *scripts[i].get();\
-        auto &script_callback = script.callback;\
-        if(script_callback.callback_function != "" && script_callback.priority == priority) {\
-            auto *&state = script.state;\
-            lua_getglobal(state, script_callback.callback_function.data());\
-            pcall(state, 0, 0);\
-        }\
-    }\
+    for_each_subscriber(&LuaScript::callback, priority, [](LuaScript &script) {\
+        pcall(script.state, 0, 0);\
+        return true;\
+    });\
 };
 
 extern void load_map_script() noexcept;
 
-static void check_timers() noexcept {
+// Timers
+//
+// Every script's timers share one min-heap ordered by the time they're next due, so checking timers when none are due
+// only looks at the top of the heap. Stopping a timer only removes it from its script; its heap entry is thrown away
+// once it reaches the top.
+struct ScheduledTimer {
+    double due_ms;
+    LuaScript *script;
+    size_t timer_id;
+};
+
+static std::vector<ScheduledTimer> timer_queue;
+
+static bool timer_due_later(const ScheduledTimer &a, const ScheduledTimer &b) noexcept {
+    return a.due_ms > b.due_ms;
+}
+
+static double timer_clock() noexcept {
     LARGE_INTEGER now_time;
     QueryPerformanceCounter(&now_time);
-    auto r = counter_time_elapsed(last_time, now_time);
-    last_time = now_time;
-    for(size_t i=0;i<scripts.size();i++) {
-        auto &script = *scripts[i];
-        auto timers = script.timers;
-        for(size_t t=0;t<timers.size();t++) {
-            auto &timer = timers[t];
-            timer.time_passed += r * 1000;
-            bool deleted = false;
-            while(timer.time_passed >= timer.interval_ms) {
-                deleted = true;
-                for(size_t to=0;to<script.timers.size();to++) {
-                    auto &timer_to = script.timers[to];
-                    if(timer.timer_id == timer_to.timer_id) {
-                        deleted = false;
-                        break;
-                    }
-                }
-                if(deleted) break;
-                lua_getglobal(script.state, timer.function.data());
-                for(size_t arg=0;arg<timer.arguments.size();arg++) {
-                    timer.arguments[arg].push_argument(script);
-                }
-                if(pcall(script.state, timer.arguments.size(), 1) == LUA_OK) {
-                    if(lua_isboolean(script.state, -1) && !lua_toboolean(script.state, -1)) {
-                        deleted = true;
-                        lua_pop(script.state, 1);
-                        break;
-                    }
-                    lua_pop(script.state, 1);
-                }
-                timer.time_passed -= timer.interval_ms;
-            }
-            for(size_t to=0;to<script.timers.size();to++) {
-                auto &timer_to = script.timers[to];
-                if(timer.timer_id == timer_to.timer_id) {
-                    if(deleted) {
-                        script.timers.erase(script.timers.begin() + to);
-                    }
-                    else {
-                        timer_to.time_passed = timer.time_passed;
-                    }
-                    break;
-                }
+    return counter_time_elapsed(timer_epoch, now_time) * 1000;
+}
+
+static void push_timer(const ScheduledTimer &timer) noexcept {
+    timer_queue.push_back(timer);
+    std::push_heap(timer_queue.begin(), timer_queue.end(), timer_due_later);
+}
+
+void schedule_timer(LuaScript &script, size_t timer_id) noexcept {
+    auto &timer = script.timers[timer_id];
+    push_timer(ScheduledTimer { timer_clock() + timer.interval_ms, &script, timer_id });
+}
+
+void stop_timer(lua_State *state, LuaScriptTimer &timer) noexcept {
+    if(timer.arguments_ref != LUA_NOREF) {
+        luaL_unref(state, LUA_REGISTRYINDEX, timer.arguments_ref);
+        timer.arguments_ref = LUA_NOREF;
+    }
+}
+
+void unschedule_timers(LuaScript &script) noexcept {
+    auto end = std::remove_if(timer_queue.begin(), timer_queue.end(), [&script](const ScheduledTimer &timer) {
+        return timer.script == &script;
+    });
+    if(end != timer_queue.end()) {
+        timer_queue.erase(end, timer_queue.end());
+        std::make_heap(timer_queue.begin(), timer_queue.end(), timer_due_later);
+    }
+}
+
+static void check_timers() noexcept {
+    if(timer_queue.empty()) return;
+    auto now = timer_clock();
+    while(!timer_queue.empty() && timer_queue.front().due_ms <= now) {
+        std::pop_heap(timer_queue.begin(), timer_queue.end(), timer_due_later);
+        auto scheduled = timer_queue.back();
+        timer_queue.pop_back();
+
+        auto &script = *scheduled.script;
+        auto timer = script.timers.find(scheduled.timer_id);
+        if(timer == script.timers.end()) continue;
+
+        // The callback may set or stop timers, so copy what's needed out of the timer before calling it.
+        auto interval = timer->second.interval_ms;
+        auto argument_count = timer->second.argument_count;
+        auto arguments_ref = timer->second.arguments_ref;
+
+        auto *state = script.state;
+        lua_getglobal(state, timer->second.function.data());
+        if(argument_count > 0) {
+            lua_rawgeti(state, LUA_REGISTRYINDEX, arguments_ref);
+            int table = lua_gettop(state);
+            for(int arg=1;arg<=argument_count;arg++) {
+                lua_rawgeti(state, table, arg);
             }
+            lua_remove(state, table);
+        }
+
+        bool stopped = false;
+        if(pcall(state, argument_count, 1) == LUA_OK) {
+            stopped = lua_isboolean(state, -1) && !lua_toboolean(state, -1);
+            lua_pop(state, 1);
+        }
+
+        timer = script.timers.find(scheduled.timer_id);
+        if(timer == script.timers.end()) continue;
+        if(stopped) {
+            stop_timer(state, timer->second);
+            script.timers.erase(timer);
+            continue;
         }
+
+        // A timer that's fallen behind fires again right away until it catches up.
+        scheduled.due_ms += interval;
+        push_timer(scheduled);
     }
 }
 
@@ -133,61 +300,54 @@ static void camera_callback() noexcept {
     auto &data = camera_data();
 
     auto x = [&data](EventPriority priority) {
-        for(size_t i=0;i<scripts.size();i++) {
-            auto &script = *scripts[i].get();
-            auto &script_callback = script.c_precamera;
-            if(script_callback.callback_function != "" && script_callback.priority == priority) {
-                auto *&state = script.state;
-                lua_getglobal(state, script_callback.callback_function.data());
-                lua_pushnumber(state, data.position.x);
-                lua_pushnumber(state, data.position.y);
-                lua_pushnumber(state, data.position.z);
-                lua_pushnumber(state, data.fov);
-                lua_pushnumber(state, data.orientation[0].x);
-                lua_pushnumber(state, data.orientation[0].y);
-                lua_pushnumber(state, data.orientation[0].z);
-                lua_pushnumber(state, data.orientation[1].x);
-                lua_pushnumber(state, data.orientation[1].y);
-                lua_pushnumber(state, data.orientation[1].z);
-                if(pcall(state, 10, 10) == LUA_OK) {
-                    if(priority != EVENT_PRIORITY_FINAL) {
-                        #define set_if_possible(val, i) if(lua_isnumber(state, i)) val = lua_tonumber(state, i)
-                        set_if_possible(data.position.x, -10);
-                        set_if_possible(data.position.y, -9);
-                        set_if_possible(data.position.z, -8);
-                        set_if_possible(data.fov, -7);
-                        set_if_possible(data.orientation[0].x, -6);
-                        set_if_possible(data.orientation[0].y, -5);
-                        set_if_possible(data.orientation[0].z, -4);
-                        set_if_possible(data.orientation[1].x, -3);
-                        set_if_possible(data.orientation[1].y, -2);
-                        set_if_possible(data.orientation[1].z, -1);
-                    }
-                    lua_pop(state, 10);
+        for_each_subscriber(&LuaScript::c_precamera, priority, [&data, priority](LuaScript &script) {
+            auto *&state = script.state;
+            lua_pushnumber(state, data.position.x);
+            lua_pushnumber(state, data.position.y);
+            lua_pushnumber(state, data.position.z);
+            lua_pushnumber(state, data.fov);
+            lua_pushnumber(state, data.orientation[0].x);
+            lua_pushnumber(state, data.orientation[0].y);
+            lua_pushnumber(state, data.orientation[0].z);
+            lua_pushnumber(state, data.orientation[1].x);
+            lua_pushnumber(state, data.orientation[1].y);
+            lua_pushnumber(state, data.orientation[1].z);
+            if(pcall(state, 10, 10) == LUA_OK) {
+                if(priority != EVENT_PRIORITY_FINAL) {
+                    #define set_if_possible(val, i) if(lua_isnumber(state, i)) val = lua_tonumber(state, i)
+                    set_if_possible(data.position.x, -10);
+                    set_if_possible(data.position.y, -9);
+                    set_if_possible(data.position.z, -8);
+                    set_if_possible(data.fov, -7);
+                    set_if_possible(data.orientation[0].x, -6);
+                    set_if_possible(data.orientation[0].y, -5);
+                    set_if_possible(data.orientation[0].z, -4);
+                    set_if_possible(data.orientation[1].x, -3);
+                    set_if_possible(data.orientation[1].y, -2);
+                    set_if_possible(data.orientation[1].z, -1);
                 }
+                lua_pop(state, 10);
             }
-        }
+            return true;
+        });
     };
     call_all_priorities(x);
 }
 
 #define allow_string_callback(callback) [](EventPriority priority, const char *string, bool &allow) noexcept {\
-    for(size_t i=0;i<scripts.size() && allow;i++) {\
-        auto &script = *scripts[i].get();\
-        auto &script_callback = script.callback;\
-        if(script_callback.callback_function != "" && script_callback.priority == priority) {\
-            auto *&state = script.state;\
-            lua_getglobal(state, script_callback.callback_function.data());\
-            lua_pushstring(state, string);\
-            if(pcall(state, 1, 1) == LUA_OK) {\
-                if(!lua_isnil(state,-1) && priority != EVENT_PRIORITY_FINAL) {\
-                    allow = lua_toboolean(state,-1);\
-                    if(script.version < 2.02) allow = !allow; /* BC */ \
-                }\
-                lua_pop(state,1);\
+    if(!allow) return;\
+    for_each_subscriber(&LuaScript::callback, priority, [priority, string, &allow](LuaScript &script) {\
+        auto *&state = script.state;\
+        lua_pushstring(state, string);\
+        if(pcall(state, 1, 1) == LUA_OK) {\
+            if(!lua_isnil(state,-1) && priority != EVENT_PRIORITY_FINAL) {\
+                allow = lua_toboolean(state,-1);\
+                if(script.version < 2.02) allow = !allow; /* BC */ \
             }\
+            lua_pop(state,1);\
         }\
-    }\
+        return allow;\
+    });\
 };
 #define call_all_priorities_allow_str(function,str,allow) function(EVENT_PRIORITY_BEFORE,str,allow); function(EVENT_PRIORITY_DEFAULT,str,allow); function(EVENT_PRIORITY_AFTER,str,allow); function(EVENT_PRIORITY_FINAL,str,allow)
 
@@ -222,10 +382,11 @@ struct UnderscoreSpaceThing {
 int lua_set_callback(lua_State *state) noexcept {
     int args = lua_gettop(state);
 
-    if(args == 1 || args == 2) {
+    if(args >= 1 && args <= 3) {
         const char *callback_name = luaL_checkstring(state,1);
         const char *function_name = "";
-        if(args == 2) {
+        bool function_given = args >= 2 && lua_isfunction(state,2);
+        if(args >= 2 && !function_given) {
             function_name = luaL_checkstring(state,2);
             if(function_name == nullptr) function_name = "";
         }
@@ -245,9 +406,16 @@ int lua_set_callback(lua_State *state) noexcept {
         #define cpref_(cb) c_ ## cb
 
         #define if_callback_then_set(cb) if(UnderscoreSpaceThing(#cb) == callback_name) {\
-            auto &callback = script_from_state(state).cpref_(cb);\
+            auto &script = script_from_state(state);\
+            auto &callback = script.cpref_(cb);\
+            unsubscribe(state, script, &LuaScript::cpref_(cb));\
             callback.callback_function = function_name;\
             callback.priority = priority;\
+            if(function_given) {\
+                lua_pushvalue(state,2);\
+                callback.function_ref = luaL_ref(state, LUA_REGISTRYINDEX);\
+            }\
+            subscribe(script, &LuaScript::cpref_(cb));\
         }
 
         if_callback_then_set(command)
@@ -287,5 +455,5 @@ void setup_callbacks() noexcept {
     add_preframe_event(preframe_callback, EVENT_PRIORITY_BEFORE);
     add_rcon_message_event(rcon_message_callback, EVENT_PRIORITY_BEFORE);
     add_precamera_event(camera_callback, EVENT_PRIORITY_AFTER);
-    QueryPerformanceCounter(&last_time);
+    QueryPerformanceCounter(&timer_epoch);
 }
@@ -5,3 +5,19 @@
 int lua_set_callback(lua_State *state) noexcept;
 
 void setup_callbacks() noexcept;
+
+/// Push the function a script set for a callback, or nil if it isn't defined.
+void push_callback_function(LuaScript &script, LuaScriptCallback &callback) noexcept;
+
+/// Remove a script from every callback it subscribed to. This must be called before the script is destroyed.
+void unsubscribe_script(LuaScript &script) noexcept;
+
+/// Schedule a timer that was just added to a script's timers. It first fires after its interval.
+void schedule_timer(LuaScript &script, size_t timer_id) noexcept;
+
+/// Release a timer's arguments using state, the thread stopping it. The timer should then be erased from the script's
+/// timers.
+void stop_timer(lua_State *state, LuaScriptTimer &timer) noexcept;
+
+/// Drop every scheduled timer belonging to a script. This must be called before the script is destroyed.
+void unschedule_timers(LuaScript &script) noexcept;
@@ -5,10 +5,13 @@
 
 #include "../command/console.h"
 #include "../halo_data/global.h"
+#include "../halo_data/object_changes.h"
+#include "../halo_data/object_grid.h"
 #include "../halo_data/script.h"
 #include "../halo_data/spawn_object.h"
 #include "../halo_data/table.h"
 #include "../halo_data/tag_data.h"
+#include "../halo_data/tag_dependencies.h"
 #include "../hooks/tick.h"
 #include "../messaging/messaging.h"
 
@@ -129,6 +132,67 @@ static int lua_get_object(lua_State *state) noexcept {
     }
 }
 
+// Set field of the table on top of the stack to an array of object IDs.
+static void set_object_id_field(lua_State *state, const char *field, const std::vector<uint32_t> &ids) noexcept {
+    lua_createtable(state, ids.size(), 0);
+    for(size_t i=0;i<ids.size();i++) {
+        lua_pushinteger(state, ids[i]);
+        lua_rawseti(state, -2, i + 1);
+    }
+    lua_setfield(state, -2, field);
+}
+
+static int lua_get_object_changes(lua_State *state) noexcept {
+    auto &changes = object_changes();
+    std::vector<uint32_t> moved;
+    for(size_t w=0;w<changes.moved.size();w++) {
+        for(uint32_t mask = changes.moved[w]; mask; mask &= mask - 1) {
+            size_t bit = 0;
+            while(!((mask >> bit) & 1)) bit++;
+            moved.push_back(object_changes_id(w * 32 + bit));
+        }
+    }
+
+    lua_createtable(state, 0, 5);
+    lua_pushinteger(state, changes.tick);
+    lua_setfield(state, -2, "tick");
+    set_object_id_field(state, "spawned", changes.spawned);
+    set_object_id_field(state, "deleted", changes.deleted);
+    set_object_id_field(state, "tag_changed", changes.tag_changed);
+    set_object_id_field(state, "moved", moved);
+    return 1;
+}
+
+static int lua_find_objects_near(lua_State *state) noexcept {
+    int args = lua_gettop(state);
+    if(args == 4 || args == 5) {
+        Vector3D point;
+        point.x = luaL_checknumber(state, 1);
+        point.y = luaL_checknumber(state, 2);
+        point.z = luaL_checknumber(state, 3);
+        float radius = luaL_checknumber(state, 4);
+        int type = args == 5 ? luaL_checkinteger(state, 5) : -1;
+
+        std::vector<uint32_t> found;
+        find_objects_near(point, radius, found);
+
+        lua_createtable(state, found.size(), 0);
+        size_t count = 0;
+        for(auto id : found) {
+            if(type != -1) {
+                auto *object_data = reinterpret_cast<BaseHaloObject *>(HaloObject(id).object_data());
+                if(!object_data || object_data->object_type != type) continue;
+            }
+            lua_pushinteger(state, id);
+            lua_rawseti(state, -2, ++count);
+        }
+        return 1;
+    }
+    else {
+        return luaL_error(state,"wrong number of arguments in find_objects_near");
+    }
+}
+
 static int lua_get_player(lua_State *state) noexcept {
     int args = lua_gettop(state);
     if(args <= 1) {
@@ -159,12 +223,11 @@ static int lua_get_tag(lua_State *state) noexcept {
         return 1;
     }
     else if(args == 2) {
-        try {
-            lua_pushinteger(state, reinterpret_cast<uint32_t>(&HaloTag::lookup(luaL_checkstring(state, 1), luaL_checkstring(state, 2))));
-        }
-        catch(...) {
+        auto *tag = HaloTag::lookup(luaL_checkstring(state, 1), luaL_checkstring(state, 2));
+        if(tag)
+            lua_pushinteger(state, reinterpret_cast<uint32_t>(tag));
+        else
             lua_pushnil(state);
-        }
         return 1;
     }
     else {
@@ -172,6 +235,44 @@ static int lua_get_tag(lua_State *state) noexcept {
     }
 }
 
+// Push a table of the tag IDs in a tag's dependencies or dependents. The tag is given either as a tag ID or as a tag
+// class and path.
+static int push_tag_ids(lua_State *state, const char *function, const uint32_t *(*get_ids)(const HaloTagID &, size_t &)) noexcept {
+    int args = lua_gettop(state);
+    HaloTagID tag_id = 0xFFFFFFFF;
+    if(args == 1) {
+        tag_id = static_cast<uint32_t>(luaL_checkinteger(state, 1));
+    }
+    else if(args == 2) {
+        auto *tag = HaloTag::lookup(luaL_checkstring(state, 1), luaL_checkstring(state, 2));
+        if(tag) tag_id = tag->id;
+    }
+    else {
+        return luaL_error(state,"wrong number of arguments in %s", function);
+    }
+
+    size_t count;
+    auto *ids = get_ids(tag_id, count);
+    if(!ids) {
+        lua_pushnil(state);
+        return 1;
+    }
+    lua_createtable(state, count, 0);
+    for(size_t i=0;i<count;i++) {
+        lua_pushinteger(state, ids[i]);
+        lua_rawseti(state, -2, i + 1);
+    }
+    return 1;
+}
+
+static int lua_get_tag_dependencies(lua_State *state) noexcept {
+    return push_tag_ids(state, "get_tag_dependencies", tag_dependencies);
+}
+
+static int lua_get_tag_dependents(lua_State *state) noexcept {
+    return push_tag_ids(state, "get_tag_dependents", tag_dependents);
+}
+
 static int lua_hud_message(lua_State *state) noexcept {
     int args = lua_gettop(state);
     if(args == 1) {
@@ -251,14 +352,32 @@ static int lua_set_timer(lua_State *state) noexcept {
         }
         auto *function = luaL_checkstring(state, 2);
         LuaScriptTimer timer;
-        timer.timer_id = script.next_timer_id++;
         timer.interval_ms = interval;
         timer.function = function;
-        for(size_t i=3;i<=args;i++) {
-            timer.arguments.push_back(LuaAmbiguousTypeArgument::check_argument(script, i, true));
+
+        // Arguments are kept in a table in the registry rather than copied out of Lua.
+        if(args > 2) {
+            lua_createtable(state, args - 2, 0);
+            int table = lua_gettop(state);
+            for(int i=3;i<=args;i++) {
+                // Numbers have always been passed as strings, and before 2.03, so was everything else.
+                if(script.version < 2.03 || lua_type(state, i) == LUA_TNUMBER) { // BC
+                    luaL_checkstring(state, i);
+                }
+                else if(!lua_isboolean(state, i) && !lua_isstring(state, i) && !lua_isnil(state, i)) {
+                    return luaL_error(state, "timer argument must be boolean, string, number, or nil");
+                }
+                lua_pushvalue(state, i);
+                lua_rawseti(state, table, i - 2);
+            }
+            timer.argument_count = args - 2;
+            timer.arguments_ref = luaL_ref(state, LUA_REGISTRYINDEX);
         }
-        lua_pushinteger(state, timer.timer_id);
-        script.timers.emplace_back(timer);
+
+        auto timer_id = script.next_timer_id++;
+        script.timers.emplace(timer_id, std::move(timer));
+        schedule_timer(script, timer_id);
+        lua_pushinteger(state, timer_id);
         return 1;
     }
     else {
@@ -271,12 +390,13 @@ static int lua_stop_timer(lua_State *state) noexcept {
     if(args == 1) {
         auto &script = script_from_state(state);
         auto id = luaL_checkinteger(state, 1);
-        for(size_t i=0;i<script.timers.size();i++) {
-            if(script.timers[i].timer_id == id) {
-                script.timers.erase(script.timers.begin() + i);
-                return luaL_error(state,"timer with that ID does not exist");
-            }
+        // Timers that already stopped themselves are quietly ignored.
+        auto timer = script.timers.find(id);
+        if(timer == script.timers.end()) {
+            return 0;
         }
+        stop_timer(state, timer->second);
+        script.timers.erase(timer);
         return 0;
     }
     else {
@@ -294,12 +414,11 @@ static int lua_spawn_object(lua_State *state) noexcept {
             a = 1;
         }
         else {
-            try {
-                tag_id = HaloTag::lookup(luaL_checkstring(state, 1), luaL_checkstring(state, 2)).id;
-            }
-            catch(...) {
+            auto *tag = HaloTag::lookup(luaL_checkstring(state, 1), luaL_checkstring(state, 2));
+            if(!tag) {
                 return luaL_error(state,"could not find tag");
             }
+            tag_id = tag->id;
             a = 2;
         }
         if(static_cast<uint16_t>(tag_id) >= *reinterpret_cast<uint32_t *>(0x4044000C)) {
@@ -340,11 +459,15 @@ void set_game_functions(lua_State *state) noexcept {
     lua_register(state, "console_out", lua_console_out);
     lua_register(state, "delete_object", lua_delete_object);
     lua_register(state, "execute_script", lua_execute_script);
+    lua_register(state, "find_objects_near", lua_find_objects_near);
     lua_register(state, "get_dynamic_player", lua_get_dynamic_player);
     lua_register(state, "get_global", lua_get_global);
     lua_register(state, "get_object", lua_get_object);
+    lua_register(state, "get_object_changes", lua_get_object_changes);
     lua_register(state, "get_player", lua_get_player);
     lua_register(state, "get_tag", lua_get_tag);
+    lua_register(state, "get_tag_dependencies", lua_get_tag_dependencies);
+    lua_register(state, "get_tag_dependents", lua_get_tag_dependents);
     lua_register(state, "hud_message", lua_hud_message);
     lua_register(state, "set_callback", lua_set_callback);
     lua_register(state, "set_global", lua_set_global);
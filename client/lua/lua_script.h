@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../../version.h"
@@ -9,38 +10,32 @@
 #include "../messaging/messaging.h"
 
 struct LuaScriptCallback {
+    /// Name of the global to call. It's looked up with lua_getglobal() every time the callback fires, so that
+    /// reassigning the global changes the callback.
     std::string callback_function;
     EventPriority priority;
+
+    /// Registry reference to the function if set_callback() was given a function rather than a global's name, or
+    /// LUA_NOREF. This is called directly without looking anything up.
+    int function_ref = LUA_NOREF;
 };
 
 struct LuaScript;
 
-struct LuaAmbiguousTypeArgument {
-    enum {
-        ARGUMENT_BOOLEAN,
-        ARGUMENT_STRING,
-        ARGUMENT_NUMBER,
-        ARGUMENT_NIL
-    } argument_type;
-    std::string string_value;
-    double number_value;
-    bool bool_value;
-    static LuaAmbiguousTypeArgument check_argument(LuaScript &script, int arg, bool do_lua_error);
-    void push_argument(LuaScript &script) noexcept;
-};
-
 struct LuaScriptTimer {
     double interval_ms;
-    double time_passed = 0;
     std::string function;
-    size_t timer_id;
-    std::vector<LuaAmbiguousTypeArgument> arguments;
+
+    /// Registry reference to a table holding the arguments, or LUA_NOREF if there aren't any
+    int arguments_ref = LUA_NOREF;
+    int argument_count = 0;
 };
 
 struct LuaScript {
     lua_State *state = nullptr;
 
-    std::vector<LuaScriptTimer> timers;
+    /// Timers by ID; the times they're due are kept by the scheduler in lua_callback.cpp
+    std::unordered_map<size_t, LuaScriptTimer> timers;
 
     double version = CHIMERA_LUA_INTERPRETER;
 
@@ -74,6 +69,8 @@ struct LuaScript {
     ~LuaScript() noexcept;
 };
 
+/// Get the script a state belongs to. state may be one of the script's coroutines, so use state rather than the
+/// script's own state for anything that touches the stack.
 LuaScript &script_from_state(lua_State *state) noexcept;
 void refresh_client_index(lua_State *state) noexcept;
 void refresh_variables(lua_State *state) noexcept;
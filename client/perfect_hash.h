@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Perfect hash tables for fixed sets of string keys, built at compile time.
+//
+// Keys are first hashed into buckets, and each bucket gets a seed (found when the table is built) that sends all of its
+// keys to slots nobody else uses. A lookup is two hashes of the key and one string comparison against a single slot.
+
+template<typename T> struct PerfectHashEntry {
+    const char *key;
+    T value;
+};
+
+/// Hash a string with a seed (FNV-1a with a final mix so the low bits are usable).
+constexpr uint32_t perfect_hash_string(const char *string, uint32_t seed) noexcept {
+    uint32_t hash = 0x811C9DC5 ^ (seed * 0x9E3779B9);
+    for(const char *c = string; *c; c++) {
+        hash = (hash ^ static_cast<unsigned char>(*c)) * 0x01000193;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6B;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+constexpr bool perfect_hash_strings_equal(const char *a, const char *b) noexcept {
+    while(*a && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+template<typename T, size_t N> class PerfectHashMap {
+public:
+    /// Slots in the table. Keeping this at least twice the key count makes the per-bucket seeds quick to find.
+    static constexpr size_t SLOT_COUNT = [] {
+        size_t slots = 1;
+        while(slots < N * 2) slots <<= 1;
+        return slots;
+    }();
+
+    static constexpr size_t BUCKET_COUNT = N / 2 + 1;
+
+    /// Build the table. If there are duplicate keys, this fails and valid() returns false.
+    constexpr PerfectHashMap(const PerfectHashEntry<T> (&entries)[N], T not_found) noexcept : not_found(not_found) {
+        size_t bucket_of[N] = {};
+        size_t bucket_size[BUCKET_COUNT] = {};
+        size_t largest_bucket = 0;
+        for(size_t e = 0; e < N; e++) {
+            bucket_of[e] = perfect_hash_string(entries[e].key, 0) % BUCKET_COUNT;
+            size_t size = ++bucket_size[bucket_of[e]];
+            if(size > largest_bucket) largest_bucket = size;
+        }
+
+        // Place the biggest buckets first while the table is mostly empty.
+        for(size_t size = largest_bucket; size > 0; size--) {
+            for(size_t b = 0; b < BUCKET_COUNT; b++) {
+                if(bucket_size[b] != size) continue;
+
+                bool placed = false;
+                for(uint32_t seed = 1; seed < 0x10000 && !placed; seed++) {
+                    size_t slots[N] = {};
+                    size_t slot_count = 0;
+                    placed = true;
+                    for(size_t e = 0; e < N && placed; e++) {
+                        if(bucket_of[e] != b) continue;
+                        size_t slot = perfect_hash_string(entries[e].key, seed) & (SLOT_COUNT - 1);
+                        if(keys[slot]) placed = false;
+                        for(size_t s = 0; s < slot_count && placed; s++) {
+                            if(slots[s] == slot) placed = false;
+                        }
+                        slots[slot_count++] = slot;
+                    }
+                    if(!placed) continue;
+
+                    seeds[b] = seed;
+                    slot_count = 0;
+                    for(size_t e = 0; e < N; e++) {
+                        if(bucket_of[e] != b) continue;
+                        keys[slots[slot_count]] = entries[e].key;
+                        values[slots[slot_count]] = entries[e].value;
+                        slot_count++;
+                    }
+                }
+                if(!placed) return;
+            }
+        }
+        built = true;
+    }
+
+    /// Return true if every key got a slot. Use this in a static_assert wherever a table is defined.
+    constexpr bool valid() const noexcept {
+        return built;
+    }
+
+    /// Look up a key, returning the not_found value if it isn't in the table.
+    constexpr T find(const char *key) const noexcept {
+        size_t slot = perfect_hash_string(key, seeds[perfect_hash_string(key, 0) % BUCKET_COUNT]) & (SLOT_COUNT - 1);
+        return keys[slot] && perfect_hash_strings_equal(keys[slot], key) ? values[slot] : not_found;
+    }
+
+private:
+    const char *keys[SLOT_COUNT] = {};
+    T values[SLOT_COUNT] = {};
+    uint32_t seeds[BUCKET_COUNT] = {};
+    T not_found;
+    bool built = false;
+};
+
+/// Build a PerfectHashMap, deducing the key count.
+template<typename T, size_t N> constexpr PerfectHashMap<T, N> make_perfect_hash_map(const PerfectHashEntry<T> (&entries)[N], T not_found) noexcept {
+    return PerfectHashMap<T, N>(entries, not_found);
+}
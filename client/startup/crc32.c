@@ -40,8 +40,21 @@
  * CRC32 code derived from work by Gary S. Brown.
  */
 
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#define CRC32_CLMUL
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
 
 static uint32_t crc32_tab[] = {
 	0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f,
@@ -89,6 +102,199 @@ static uint32_t crc32_tab[] = {
 	0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
 };
 
+/*
+ * Slice-by-16: crc32_tab_16[k][n] is the CRC of byte n followed by k zero bytes, so sixteen bytes can be folded in with
+ * sixteen independent table lookups instead of sixteen dependent ones. The tables are derived from crc32_tab the first
+ * time they're needed.
+ *
+ * Maps are hashed from several threads at once, so only one thread builds the tables, and the release store of
+ * CRC32_TABLES_READY publishes them. Any other thread that needs them before then falls back to crc32_bytes rather
+ * than waiting.
+ */
+#define CRC32_TABLES_NOT_BUILT 0
+#define CRC32_TABLES_BUILDING 1
+#define CRC32_TABLES_READY 2
+
+static uint32_t crc32_tab_16[16][256];
+static atomic_int crc32_tab_16_state = CRC32_TABLES_NOT_BUILT;
+
+/* Return nonzero if crc32_tab_16 can be used, building it first if no other thread is. */
+static int crc32_tables_ready(void)
+{
+	int i, k;
+	int state = atomic_load_explicit(&crc32_tab_16_state, memory_order_acquire);
+
+	if (state == CRC32_TABLES_READY)
+		return 1;
+	if (state != CRC32_TABLES_NOT_BUILT || !atomic_compare_exchange_strong_explicit(&crc32_tab_16_state, &state, CRC32_TABLES_BUILDING, memory_order_acquire, memory_order_acquire))
+		return 0;
+
+	for (i = 0; i < 256; i++) {
+		crc32_tab_16[0][i] = crc32_tab[i];
+		for (k = 1; k < 16; k++)
+			crc32_tab_16[k][i] = (crc32_tab_16[k - 1][i] >> 8) ^ crc32_tab[crc32_tab_16[k - 1][i] & 0xFF];
+	}
+	atomic_store_explicit(&crc32_tab_16_state, CRC32_TABLES_READY, memory_order_release);
+	return 1;
+}
+
+static inline uint32_t crc32_read32(const uint8_t *p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v)); /* little endian */
+	return v;
+}
+
+static uint32_t crc32_bytes(uint32_t crc, const uint8_t *p, size_t size)
+{
+	while (size--)
+		crc = crc32_tab[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+	return crc;
+}
+
+static uint32_t crc32_slice_by_16(uint32_t crc, const uint8_t *p, size_t size)
+{
+	const uint32_t (*t)[256] = crc32_tab_16;
+
+	while (size >= 16) {
+		uint32_t a = crc32_read32(p) ^ crc;
+		uint32_t b = crc32_read32(p + 4);
+		uint32_t c = crc32_read32(p + 8);
+		uint32_t d = crc32_read32(p + 12);
+
+		crc = t[15][a & 0xFF] ^ t[14][(a >> 8) & 0xFF] ^ t[13][(a >> 16) & 0xFF] ^ t[12][a >> 24] ^
+		      t[11][b & 0xFF] ^ t[10][(b >> 8) & 0xFF] ^ t[9][(b >> 16) & 0xFF] ^ t[8][b >> 24] ^
+		      t[7][c & 0xFF] ^ t[6][(c >> 8) & 0xFF] ^ t[5][(c >> 16) & 0xFF] ^ t[4][c >> 24] ^
+		      t[3][d & 0xFF] ^ t[2][(d >> 8) & 0xFF] ^ t[1][(d >> 16) & 0xFF] ^ t[0][d >> 24];
+
+		p += 16;
+		size -= 16;
+	}
+
+	return crc32_bytes(crc, p, size);
+}
+
+#ifdef CRC32_CLMUL
+#ifdef __GNUC__
+#define CRC32_CLMUL_FUNCTION __attribute__((target("sse2,pclmul"), force_align_arg_pointer))
+#else
+#define CRC32_CLMUL_FUNCTION
+#endif
+
+/*
+ * Carry-less multiplication folding, from Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+ * Instruction". The constants are the bit-reflected ones given at the end of the paper for this polynomial.
+ *
+ * size must be at least 64 and a multiple of 16. crc is the raw (non-inverted) register value.
+ */
+CRC32_CLMUL_FUNCTION
+static uint32_t crc32_clmul(uint32_t crc, const uint8_t *p, size_t size)
+{
+	static const uint64_t k1k2[] = { 0x0154442bd4ULL, 0x01c6e41596ULL };
+	static const uint64_t k3k4[] = { 0x01751997d0ULL, 0x00ccaa009eULL };
+	static const uint64_t k5k0[] = { 0x0163cd6124ULL, 0x0000000000ULL };
+	static const uint64_t poly[] = { 0x01db710641ULL, 0x01f7011641ULL };
+
+	__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+	x1 = _mm_loadu_si128((const __m128i *)(p + 0x00));
+	x2 = _mm_loadu_si128((const __m128i *)(p + 0x10));
+	x3 = _mm_loadu_si128((const __m128i *)(p + 0x20));
+	x4 = _mm_loadu_si128((const __m128i *)(p + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+	p += 64;
+	size -= 64;
+
+	/* fold four 128-bit lanes at a time */
+	x0 = _mm_loadu_si128((const __m128i *)k1k2);
+	while (size >= 64) {
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+		x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)(p + 0x00)));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(p + 0x10)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(p + 0x20)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(p + 0x30)));
+
+		p += 64;
+		size -= 64;
+	}
+
+	/* fold the four lanes into one */
+	x0 = _mm_loadu_si128((const __m128i *)k3k4);
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+	/* fold any remaining 128-bit blocks */
+	while (size >= 16) {
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *)p)), x5);
+		p += 16;
+		size -= 16;
+	}
+
+	/* 128 bits to 64 */
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+	x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x1 = _mm_srli_si128(x1, 8);
+	x1 = _mm_xor_si128(x1, x2);
+
+	x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, x3);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	/* Barrett reduction to 32 bits */
+	x0 = _mm_loadu_si128((const __m128i *)poly);
+	x2 = _mm_and_si128(x1, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+	x2 = _mm_and_si128(x2, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	return (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(x1, 4));
+}
+
+/* -1 = not checked yet. Every thread that checks gets the same answer, so relaxed accesses are enough. */
+static atomic_int crc32_has_clmul = -1;
+
+static int crc32_check_clmul(void)
+{
+	unsigned int c, d;
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	c = (unsigned int)info[2];
+	d = (unsigned int)info[3];
+#else
+	unsigned int a, b;
+	if (!__get_cpuid(1, &a, &b, &c, &d))
+		return 0;
+#endif
+	/* PCLMULQDQ is ECX bit 1, SSE2 is EDX bit 26 */
+	return (c & (1U << 1)) && (d & (1U << 26));
+}
+#endif
+
 uint32_t crc32(uint32_t crc, const void *buf, size_t size)
 {
 	const uint8_t *p;
@@ -96,8 +302,76 @@ uint32_t crc32(uint32_t crc, const void *buf, size_t size)
 	p = buf;
 	crc = crc ^ ~0U;
 
-	while (size--)
-		crc = crc32_tab[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+#ifdef CRC32_CLMUL
+	if (size >= 64) {
+		int has_clmul = atomic_load_explicit(&crc32_has_clmul, memory_order_relaxed);
+		if (has_clmul < 0) {
+			has_clmul = crc32_check_clmul();
+			atomic_store_explicit(&crc32_has_clmul, has_clmul, memory_order_relaxed);
+		}
+		if (has_clmul) {
+			size_t folded = size & ~(size_t)15;
+			crc = crc32_clmul(crc, p, folded);
+			p += folded;
+			size -= folded;
+		}
+	}
+#endif
+
+	if (size >= 16 && crc32_tables_ready()) {
+		crc = crc32_slice_by_16(crc, p, size);
+	}
+	else {
+		crc = crc32_bytes(crc, p, size);
+	}
 
 	return crc ^ ~0U;
 }
+
+/*
+ * Combining, the same way zlib does it. Appending len2 bytes to a message multiplies its CRC by x^(8 * len2) modulo
+ * the polynomial, so the CRC of the first part can be shifted over and xored with the CRC of the second.
+ *
+ * x2n_tab[n] is x^(2^n) mod p(x).
+ */
+static const uint32_t crc32_x2n_tab[32] = {
+	0x40000000, 0x20000000, 0x08000000, 0x00800000, 0x00008000, 0xedb88320,
+	0xb1e6b092, 0xa06a2517, 0xed627dae, 0x88d14467, 0xd7bbfe6a, 0xec447f11,
+	0x8e7ea170, 0x6427800e, 0x4d47bae0, 0x09fe548f, 0x83852d0f, 0x30362f1a,
+	0x7b5a9cc3, 0x31fec169, 0x9fec022a, 0x6c8dedc4, 0x15d6874d, 0x5fde7a4e,
+	0xbad90e37, 0x2e4e5eef, 0x4eaba214, 0xa8a472c0, 0x429a969e, 0x148d302a,
+	0xc40ba6d0, 0xc4e22c3c
+};
+
+/* a * b mod p(x) */
+static uint32_t crc32_multiply(uint32_t a, uint32_t b)
+{
+	uint32_t m = (uint32_t)1 << 31;
+	uint32_t p = 0;
+
+	while (m) {
+		if (a & m) {
+			p ^= b;
+			if ((a & (m - 1)) == 0)
+				break;
+		}
+		m >>= 1;
+		b = b & 1 ? (b >> 1) ^ 0xEDB88320 : b >> 1;
+	}
+	return p;
+}
+
+uint32_t crc32_combine(uint32_t crc1, uint32_t crc2, uint64_t len2)
+{
+	/* x^(8 * len2), starting from x^0 and multiplying in x^(2^k) for each set bit of 8 * len2 */
+	uint32_t p = (uint32_t)1 << 31;
+	unsigned int k = 3;
+
+	while (len2) {
+		if (len2 & 1)
+			p = crc32_multiply(crc32_x2n_tab[k & 31], p);
+		len2 >>= 1;
+		k++;
+	}
+	return crc32_multiply(p, crc1) ^ crc2;
+}
@@ -4,4 +4,8 @@
 
 extern "C" {
     uint32_t crc32(uint32_t crc, const void *buf, size_t size);
+
+    /// Get the CRC32 of two buffers concatenated, given the CRC32 of each (both calculated from 0) and the length of
+    /// the second.
+    uint32_t crc32_combine(uint32_t crc1, uint32_t crc2, uint64_t len2);
 }
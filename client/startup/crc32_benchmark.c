@@ -0,0 +1,68 @@
+/*
+ * Report how fast each CRC32 implementation is in GB/s. crc32.c is included directly so each path can be timed on its
+ * own.
+ *
+ * Usage: crc32_benchmark [size in MiB]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "crc32.c"
+
+static double now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec / 1.0E9;
+}
+
+static volatile uint32_t sink;
+
+static void report(const char *name, const uint8_t *data, size_t size, uint32_t (*function)(uint32_t, const uint8_t *, size_t))
+{
+	double best = 0;
+	int run;
+
+	/* Take the best of a few runs to leave out page faults and other noise. */
+	for (run = 0; run < 5; run++) {
+		double start = now();
+		sink = function(~0U, data, size);
+		double rate = size / (now() - start) / 1.0E9;
+		if (rate > best)
+			best = rate;
+	}
+	printf("%-16s %6.2f GB/s\n", name, best);
+}
+
+static uint32_t run_crc32(uint32_t crc, const uint8_t *p, size_t size)
+{
+	return crc32(crc, p, size);
+}
+
+int main(int argc, char **argv)
+{
+	size_t size = (size_t)(argc > 1 ? atoi(argv[1]) : 256) * 1024 * 1024;
+	uint8_t *data;
+	size_t i;
+
+	if (size == 0) {
+		fprintf(stderr, "Usage: %s [size in MiB]\n", argv[0]);
+		return 1;
+	}
+	data = malloc(size);
+	for (i = 0; i < size; i++)
+		data[i] = (uint8_t)(i * 2654435761U >> 24);
+
+	crc32_tables_ready();
+	report("byte at a time", data, size, crc32_bytes);
+	report("slice-by-16", data, size, crc32_slice_by_16);
+#ifdef CRC32_CLMUL
+	if (crc32_check_clmul())
+		report("PCLMULQDQ", data, size & ~(size_t)15, crc32_clmul);
+#endif
+	report("crc32()", data, size, run_crc32);
+
+	free(data);
+	return 0;
+}
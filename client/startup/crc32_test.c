@@ -0,0 +1,121 @@
+/*
+ * Check crc32() and crc32_combine() bit for bit against a plain bitwise CRC32, including each of the paths crc32() can
+ * take internally. crc32.c is included directly so its static functions can be tested on their own.
+ *
+ * Usage: crc32_test
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "crc32.c"
+
+#define THREAD_COUNT 8
+#define LARGE_SIZE (4 * 1024 * 1024 + 13)
+
+static uint8_t *data;
+static uint32_t large_crc;
+static int failures = 0;
+
+/* One bit at a time, straight from the definition of the polynomial */
+static uint32_t reference_crc32(uint32_t crc, const uint8_t *p, size_t size)
+{
+	int bit;
+
+	crc = ~crc;
+	while (size--) {
+		crc ^= *p++;
+		for (bit = 0; bit < 8; bit++)
+			crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+	}
+	return ~crc;
+}
+
+static void expect(const char *what, size_t offset, size_t size, uint32_t expected, uint32_t actual)
+{
+	if (expected == actual)
+		return;
+	if (failures < 10)
+		fprintf(stderr, "%s (offset %zu, size %zu): expected 0x%08X, got 0x%08X\n", what, offset, size, expected, actual);
+	failures++;
+}
+
+/* Every thread hashes the same data as soon as it starts, so they race to build the slice-by-16 tables. */
+static void *hash_in_thread(void *unused)
+{
+	(void)unused;
+	return (void *)(uintptr_t)(crc32(0, data, LARGE_SIZE) != large_crc);
+}
+
+int main(void)
+{
+	pthread_t threads[THREAD_COUNT];
+	size_t i, offset, size;
+	int t;
+
+	data = malloc(LARGE_SIZE + 16);
+	srand(1234);
+	for (i = 0; i < LARGE_SIZE + 16; i++)
+		data[i] = (uint8_t)rand();
+	large_crc = reference_crc32(0, data, LARGE_SIZE);
+
+	/* This has to be first, before anything else builds the tables. */
+	for (t = 0; t < THREAD_COUNT; t++)
+		pthread_create(&threads[t], NULL, hash_in_thread, NULL);
+	for (t = 0; t < THREAD_COUNT; t++) {
+		void *result;
+		pthread_join(threads[t], &result);
+		if (result) {
+			fprintf(stderr, "thread %d got the wrong CRC\n", t);
+			failures++;
+		}
+	}
+	printf("first use from %d threads: done\n", THREAD_COUNT);
+
+	/* Every size up to a few hundred bytes at every alignment covers each path's leftover handling. */
+	for (offset = 0; offset < 16; offset++) {
+		for (size = 0; size <= 300; size++) {
+			uint32_t expected = reference_crc32(0, data + offset, size);
+			expect("crc32", offset, size, expected, crc32(0, data + offset, size));
+			expect("crc32 (seeded)", offset, size, reference_crc32(0x12345678, data + offset, size), crc32(0x12345678, data + offset, size));
+			expect("table", offset, size, expected, ~crc32_bytes(~0U, data + offset, size));
+			if (crc32_tables_ready())
+				expect("slice-by-16", offset, size, expected, ~crc32_slice_by_16(~0U, data + offset, size));
+#ifdef CRC32_CLMUL
+			if (crc32_check_clmul() && size >= 64 && size % 16 == 0)
+				expect("PCLMULQDQ", offset, size, expected, ~crc32_clmul(~0U, data + offset, size));
+#endif
+		}
+	}
+	printf("sizes 0-300 at 16 alignments: done\n");
+
+	expect("crc32", 0, LARGE_SIZE, large_crc, crc32(0, data, LARGE_SIZE));
+	expect("slice-by-16", 0, LARGE_SIZE, large_crc, ~crc32_slice_by_16(~0U, data, LARGE_SIZE));
+#ifdef CRC32_CLMUL
+	if (crc32_check_clmul()) {
+		size_t folded = LARGE_SIZE & ~(size_t)15;
+		expect("PCLMULQDQ", 0, LARGE_SIZE, large_crc, ~crc32_bytes(crc32_clmul(~0U, data, folded), data + folded, LARGE_SIZE - folded));
+	}
+	else {
+		printf("PCLMULQDQ is not supported by this CPU; only tested through crc32()\n");
+	}
+#endif
+
+	/* Hashing in pieces, and combining pieces hashed separately, must give the same result as hashing it all. */
+	for (i = 0; i < 1000; i++) {
+		size_t split = (size_t)rand() % LARGE_SIZE;
+		uint32_t first = crc32(0, data, split);
+		expect("crc32 (continued)", split, LARGE_SIZE, large_crc, crc32(first, data + split, LARGE_SIZE - split));
+		expect("crc32_combine", split, LARGE_SIZE, large_crc, crc32_combine(first, crc32(0, data + split, LARGE_SIZE - split), LARGE_SIZE - split));
+	}
+	expect("crc32_combine (empty)", 0, 0, large_crc, crc32_combine(large_crc, crc32(0, data, 0), 0));
+	printf("continued and combined CRCs: done\n");
+
+	free(data);
+	if (failures) {
+		printf("%d checks failed\n", failures);
+		return 1;
+	}
+	printf("all checks passed\n");
+	return 0;
+}
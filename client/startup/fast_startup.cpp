@@ -1,6 +1,11 @@
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include "fast_startup.h"
 
 #include "../halo_data/map.h"
+#include "../hooks/frame.h"
 #include "../messaging/messaging.h"
 #include "../client_signature.h"
 #include "../hac2.h"
@@ -10,12 +15,36 @@
 #include "../halo_data/tag_data.h"
 
 #include "crc32.h"
+#include "map_file.h"
+#include "stock_crc32.h"
+#include "../../map/tag_data_reader.h"
+
+// cache.bin is a header followed by entries. New and updated entries are appended; when a name shows up more than once,
+// the last entry wins. The file is rewritten without the duplicates once they make up most of it.
+#define CACHE_MAGIC 0x63726331
+#define CACHE_VERSION 2
+
+struct CacheHeader {
+    uint32_t magic = CACHE_MAGIC;
+    uint32_t version = CACHE_VERSION;
+};
 
 struct CacheEntry {
     char name[64] = {};
     uint32_t crc32;
+
+    /// CRC32 of the first and last 64 KiB of the file, checked if the modification time changes.
+    uint32_t partial_crc32;
+
+    uint64_t file_size;
+
+    /// Last write time as a FILETIME
+    uint64_t modified;
 };
-std::vector<CacheEntry> cache;
+
+static std::vector<CacheEntry> cache;
+static std::unordered_map<std::string, size_t> cache_index;
+static size_t cache_file_entries = 0;
 static bool use_cache = false;
 static bool modded_stock_maps = false;
 
@@ -29,122 +58,257 @@ static bool same_string_case_insensitive(const char *a, const char *b) {
     return false;
 }
 
+static std::string cache_key(const char *name) {
+    std::string key = name;
+    for(auto &c : key) {
+        c = tolower(c);
+    }
+    return key;
+}
+
+static void cache_path(char *path) noexcept {
+    sprintf(path, "%s\\chimera\\cache.bin", halo_path());
+}
+
+// Rewrite cache.bin with just the entries in memory.
 static bool save_cache() noexcept {
     char path[MAX_PATH] = {};
-    sprintf(path, "%s\\chimera\\cache.bin", halo_path());
-    FILE *f = fopen(path, "wb");
-    if(f) {
-        fwrite(&cache[0], sizeof(cache[0])*cache.size(), 1, f);
-        fclose(f);
+    char temp_path[MAX_PATH] = {};
+    cache_path(path);
+    sprintf(temp_path, "%s.tmp", path);
+
+    FILE *f = fopen(temp_path, "wb");
+    if(!f) return false;
+    CacheHeader header;
+    bool written = fwrite(&header, sizeof(header), 1, f) == 1 && (cache.size() == 0 || fwrite(cache.data(), sizeof(cache[0]) * cache.size(), 1, f) == 1);
+    fclose(f);
+
+    if(!written || !MoveFileExA(temp_path, path, MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFileA(temp_path);
+        return false;
+    }
+    cache_file_entries = cache.size();
+    return true;
+}
+
+// Add or replace an entry in memory only.
+static void set_cache_entry(const CacheEntry &entry) noexcept {
+    auto key = cache_key(entry.name);
+    auto found = cache_index.find(key);
+    if(found != cache_index.end()) {
+        cache[found->second] = entry;
     }
-    return f != NULL;
+    else {
+        cache_index[key] = cache.size();
+        cache.push_back(entry);
+    }
+}
+
+// Add or replace an entry, appending it to cache.bin.
+static bool add_cache_entry(const CacheEntry &entry) noexcept {
+    set_cache_entry(entry);
+
+    if(cache_file_entries >= 32 && cache_file_entries >= cache.size() * 2) return save_cache();
+
+    char path[MAX_PATH] = {};
+    cache_path(path);
+    FILE *f = fopen(path, "ab");
+    if(!f) return false;
+    bool written = fwrite(&entry, sizeof(entry), 1, f) == 1;
+    fclose(f);
+    cache_file_entries++;
+    return written;
+}
+
+static CacheEntry *find_cache_entry(const char *name) noexcept {
+    auto found = cache_index.find(cache_key(name));
+    return found == cache_index.end() ? nullptr : &cache[found->second];
 }
 
 static bool load_cache() noexcept {
     char path[MAX_PATH] = {};
-    sprintf(path, "%s\\chimera\\cache.bin", halo_path());
+    cache_path(path);
+    cache.clear();
+    cache_index.clear();
+    cache_file_entries = 0;
+
     FILE *f = fopen(path, "rb");
-    if(f) {
-        fseek(f, 0, SEEK_END);
-        size_t cache_items = ftell(f) / sizeof(CacheEntry);
-        fseek(f, 0, SEEK_SET);
-        cache.clear();
-        for(size_t i=0;i<cache_items;i++) {
-            CacheEntry ce;
-            fread(&ce, sizeof(ce), 1, f);
-            cache.push_back(ce);
+    if(!f) return false;
+    fseek(f, 0, SEEK_END);
+    size_t size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    std::vector<char> data(size);
+    bool read = size == 0 || fread(data.data(), size, 1, f) == 1;
+    fclose(f);
+
+    auto *header = reinterpret_cast<CacheHeader *>(data.data());
+    bool current = read && size >= sizeof(*header) && header->magic == CACHE_MAGIC && header->version == CACHE_VERSION;
+    if(current) {
+        auto *entries = reinterpret_cast<CacheEntry *>(data.data() + sizeof(*header));
+        cache_file_entries = (size - sizeof(*header)) / sizeof(CacheEntry);
+        for(size_t e=0;e<cache_file_entries;e++) {
+            entries[e].name[sizeof(entries[e].name) - 1] = 0;
+            set_cache_entry(entries[e]);
         }
-        fclose(f);
     }
-    return f != NULL;
+
+    // Caches from older versions are thrown out and rewritten in the current format. A partially written entry at the
+    // end is dropped too, since anything appended after it would be misaligned.
+    if(!current || (size - sizeof(*header)) % sizeof(CacheEntry) != 0) {
+        return save_cache();
+    }
+    return true;
 }
 
-// CRC of map = CRC of BSPs, model data, and tag data
-static uint32_t calculate_crc32_of_map_file(FILE *f) noexcept {
-    uint32_t crc = 0;
-    MapHeader header;
-    fread(&header, sizeof(header), 1, f);
+struct MapRegion {
+    uint64_t offset;
+    uint64_t size;
+    uint32_t crc;
+};
 
-    auto *tag_data = new char[header.tag_data_size];
-    fseek(f, header.tag_data_offset, SEEK_SET);
-    fread(tag_data, header.tag_data_size, 1, f);
+// Regions get split into pieces this big so large BSPs and tag data can be spread across threads, too.
+#define MAP_CRC_CHUNK_SIZE (4 * 1024 * 1024)
+
+// Most of the work is waiting on the disk or page cache past this point.
+#define MAP_CRC_MAX_THREADS 8
+
+static void add_map_region(std::vector<MapRegion> &regions, uint64_t offset, uint64_t size) {
+    do {
+        uint64_t chunk = size > MAP_CRC_CHUNK_SIZE ? MAP_CRC_CHUNK_SIZE : size;
+        regions.push_back(MapRegion { offset, chunk, 0 });
+        offset += chunk;
+        size -= chunk;
+    } while(size > 0);
+}
+
+static bool read_map_file(uint64_t offset, void *output, size_t size, void *user) noexcept {
+    return reinterpret_cast<MapFile *>(user)->read(offset, output, size);
+}
+
+// Get the regions of a map file that make up its CRC, in order: BSPs, model data, and tag data
+static bool get_map_crc_regions(MapFile &file, std::vector<MapRegion> &regions) noexcept {
+    MapHeader header;
+    if(!file.read(0, &header, sizeof(header)) || header.tag_data_size > file.size()) return false;
 
-    auto *scenario_tag = tag_data + (*reinterpret_cast<uint32_t *>(tag_data) - 0x40440000) + (*reinterpret_cast<uint32_t *>(tag_data + 4) & 0xFFFF) * 0x20;
-    auto *scenario_tag_data = tag_data + (*reinterpret_cast<uint32_t *>(scenario_tag + 0x14) - 0x40440000);
+    // Only the fields needed to find the BSPs and model data are read. The tag data itself is hashed in place below.
+    TagDataReader tag_data(header, read_map_file, &file);
+    MapTagDataHeader tag_data_header;
+    std::vector<MapStructureBSP> structure_bsps;
+    if(!tag_data.header(tag_data_header) || !tag_data.structure_bsps(structure_bsps)) return false;
 
     // First, the BSP(s)
-    auto &structure_bsp_count = *reinterpret_cast<uint32_t *>(scenario_tag_data + 0x5A4);
-    auto *structure_bsps = tag_data + (*reinterpret_cast<uint32_t *>(scenario_tag_data + 0x5A4 + 4) - 0x40440000);
-    for(size_t b=0;b<structure_bsp_count;b++) {
-        char *bsp = structure_bsps + b * 0x20;
-        auto &bsp_offset = *reinterpret_cast<uint32_t *>(bsp);
-        auto &bsp_size = *reinterpret_cast<uint32_t *>(bsp + 4);
-
-        char *bsp_data = new char[bsp_size];
-        fseek(f, bsp_offset, SEEK_SET);
-        fread(bsp_data, bsp_size, 1, f);
-        crc = crc32(crc, bsp_data, bsp_size);
-        delete[] bsp_data;
+    for(auto &structure_bsp : structure_bsps) {
+        add_map_region(regions, structure_bsp.file_offset, structure_bsp.size);
     }
 
     // Next, model data
-    auto &model_vertices_offset = *reinterpret_cast<uint32_t *>(tag_data + 0x14);
-    auto &vertices_size = *reinterpret_cast<uint32_t *>(tag_data + 0x20);
-
-    auto *model_vertices = new char[vertices_size];
-    fseek(f, model_vertices_offset, SEEK_SET);
-    fread(model_vertices, vertices_size, 1, f);
-    crc = crc32(crc, model_vertices, vertices_size);
-    delete[] model_vertices;
+    add_map_region(regions, tag_data_header.model_data_offset, tag_data_header.model_data_size);
 
     // Lastly, tag data
-    crc = crc32(crc, tag_data, header.tag_data_size);
-    delete[] tag_data;
+    add_map_region(regions, header.tag_data_offset, header.tag_data_size);
+    return true;
+}
+
+// CRC of map = CRC of BSPs, model data, and tag data
+//
+// Each region is hashed separately (on up to max_threads threads), and then the results are combined, which gives the
+// same CRC as hashing them all one after the other. If paused is set, hashing waits between regions while it's true.
+static bool calculate_crc32_of_map_file(MapFile &file, uint32_t &crc, size_t max_threads = MAP_CRC_MAX_THREADS, const std::atomic<bool> *paused = nullptr) noexcept {
+    std::vector<MapRegion> regions;
+    if(!get_map_crc_regions(file, regions)) return false;
+
+    std::atomic<size_t> next_region(0);
+    std::atomic<bool> failed(false);
+    auto hash_regions = [&]() {
+        for(size_t r = next_region++; r < regions.size() && !failed; r = next_region++) {
+            while(paused && *paused) Sleep(250);
+            if(!file.crc32(regions[r].crc, regions[r].offset, regions[r].size)) failed = true;
+        }
+    };
+
+    size_t thread_count = std::thread::hardware_concurrency();
+    if(thread_count > max_threads) thread_count = max_threads;
+    if(thread_count > regions.size()) thread_count = regions.size();
+
+    // This thread does its share, too.
+    std::vector<std::thread> threads;
+    for(size_t t=1;t<thread_count;t++) {
+        threads.emplace_back(hash_regions);
+    }
+    hash_regions();
+    for(auto &thread : threads) {
+        thread.join();
+    }
+    if(failed) return false;
+
+    crc = regions[0].crc;
+    for(size_t r=1;r<regions.size();r++) {
+        crc = crc32_combine(crc, regions[r].crc, regions[r].size);
+    }
+    return true;
+}
 
-    return crc;
+bool find_map_file(const char *map_name, char *map_path) noexcept {
+    sprintf(map_path, "maps\\%s.map", map_name);
+    if(GetFileAttributesA(map_path) != INVALID_FILE_ATTRIBUTES) return true;
+    if(open_sauce_present()) {
+        sprintf(map_path, "maps\\%s.yelo", map_name);
+        if(GetFileAttributesA(map_path) != INVALID_FILE_ATTRIBUTES) return true;
+    }
+    if(hac2_present()) {
+        sprintf(map_path, "%s\\hac\\maps\\%s.map", halo_path(), map_name);
+        if(GetFileAttributesA(map_path) != INVALID_FILE_ATTRIBUTES) return true;
+    }
+    return false;
+}
+
+// Get the size and last write time of a file.
+static bool get_map_file_stats(const char *map_path, uint64_t &size, uint64_t &modified) noexcept {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if(!GetFileAttributesExA(map_path, GetFileExInfoStandard, &data)) return false;
+    size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+    modified = (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+    return true;
 }
 
-static uint32_t stock_crc32(const std::string &name) {
-    if(name == "beavercreek")
-        return 0x07B3876A;
-    else if(name == "sidewinder")
-        return 0xBD95CF55;
-    else if(name == "damnation")
-        return 0x0FBA059D;
-    else if(name == "ratrace")
-        return 0xF7F8E14C;
-    else if(name == "prisoner")
-        return 0x43B81A8B;
-    else if(name == "hangemhigh")
-        return 0xA7C8B9C6;
-    else if(name == "chillout")
-        return 0x93C53C27;
-    else if(name == "carousel")
-        return 0x9C301A08;
-    else if(name == "boardingaction")
-        return 0xF4DEEF94;
-    else if(name == "bloodgulch")
-        return 0x7B309554;
-    else if(name == "wizard")
-        return 0xCF3359B1;
-    else if(name == "putput")
-        return 0xAF2F0B84;
-    else if(name == "longest")
-        return 0xC8F48FF6;
-    else if(name == "dangercanyon")
-        return 0xC410CD74;
-    else if(name == "deathisland")
-        return 0x1DF8C97F;
-    else if(name == "gephyrophobia")
-        return 0xD2872165;
-    else if(name == "infinity")
-        return 0x0E7F7FE7;
-    else if(name == "timberland")
-        return 0x54446470;
-    else if(name == "icefields")
-        return 0x5EC1DEB7;
-    else
-        return 0xFFFFFFFF;
+// Maps that are copied or re-extracted get a new modification time without changing, so a cheap hash of both ends of the
+// file is used to tell those apart from edited maps.
+#define PARTIAL_CRC_SIZE (64 * 1024)
+
+static bool calculate_partial_crc32(MapFile &file, uint32_t &crc) noexcept {
+    uint64_t size = file.size();
+    if(size <= PARTIAL_CRC_SIZE * 2) return file.crc32(crc, 0, size);
+    uint32_t end_crc;
+    if(!file.crc32(crc, 0, PARTIAL_CRC_SIZE) || !file.crc32(end_crc, size - PARTIAL_CRC_SIZE, PARTIAL_CRC_SIZE)) return false;
+    crc = crc32_combine(crc, end_crc, PARTIAL_CRC_SIZE);
+    return true;
+}
+
+// Check that a cache entry still matches the map file. If only the modification time changed, the entry's is updated and
+// updated is set.
+static bool validate_cache_entry(CacheEntry &entry, const char *map_path, bool &updated) noexcept {
+    updated = false;
+    uint64_t size, modified;
+    if(!get_map_file_stats(map_path, size, modified) || size != entry.file_size) return false;
+    if(modified == entry.modified) return true;
+
+    MapFile file(map_path);
+    uint32_t partial_crc;
+    if(!calculate_partial_crc32(file, partial_crc) || partial_crc != entry.partial_crc32) return false;
+    entry.modified = modified;
+    updated = true;
+    return true;
+}
+
+// Hash a map and fill out a cache entry for it.
+static bool make_cache_entry(const char *map_name, const char *map_path, CacheEntry &entry, size_t max_threads = MAP_CRC_MAX_THREADS, const std::atomic<bool> *paused = nullptr) noexcept {
+    if(!get_map_file_stats(map_path, entry.file_size, entry.modified)) return false;
+    MapFile file(map_path);
+    uint32_t crc;
+    if(!calculate_crc32_of_map_file(file, crc, max_threads, paused) || !calculate_partial_crc32(file, entry.partial_crc32)) return false;
+    strncpy(entry.name, map_name, sizeof(entry.name) - 1);
+    entry.crc32 = ~crc;
+    return true;
 }
 
 static void do_crc_things() noexcept {
@@ -156,37 +320,24 @@ static void do_crc_things() noexcept {
                 indices[i].crc32 = stock_crc32(indices[i].file_name);
             }
 
-            if(indices[i].crc32 == 0xFFFFFFFF && use_cache) {
-                for(size_t c=0;c<cache.size();c++) {
-                    if(same_string_case_insensitive(indices[i].file_name, cache[c].name)) {
-                        indices[i].crc32 = cache[c].crc32;
+            char map_path[MAX_PATH] = {};
+            if(indices[i].crc32 == 0xFFFFFFFF && use_cache && find_map_file(indices[i].file_name, map_path)) {
+                auto *entry = find_cache_entry(indices[i].file_name);
+                bool updated;
+                if(entry && validate_cache_entry(*entry, map_path, updated)) {
+                    indices[i].crc32 = entry->crc32;
+                    if(updated && !add_cache_entry(CacheEntry(*entry))) {
+                        console_out_error("Error: Unable to save to cache.");
                     }
                 }
             }
 
-            if(indices[i].crc32 == 0xFFFFFFFF) {
-                char map_path[MAX_PATH] = {};
-                sprintf(map_path, "maps\\%s.map", indices[i].file_name);
-                FILE *f = fopen(map_path, "rb");
-                if(!f && open_sauce_present()) {
-                    sprintf(map_path, "maps\\%s.yelo", indices[i].file_name);
-                    f = fopen(map_path, "rb");
-                }
-                if(!f && hac2_present()) {
-                    sprintf(map_path, "%s\\hac\\maps\\%s.map", halo_path(), indices[i].file_name);
-                    f = fopen(map_path, "rb");
-                }
-                if(f) {
-                    indices[i].crc32 = ~calculate_crc32_of_map_file(f);
-                    fclose(f);
-                    if(use_cache) {
-                        CacheEntry ce;
-                        strcpy(ce.name, indices[i].file_name);
-                        ce.crc32 = indices[i].crc32;
-                        cache.push_back(ce);
-                        if(!save_cache()) {
-                            console_out_error("Error: Unable to save to cache.");
-                        }
+            if(indices[i].crc32 == 0xFFFFFFFF && (*map_path || find_map_file(indices[i].file_name, map_path))) {
+                CacheEntry entry;
+                if(make_cache_entry(indices[i].file_name, map_path, entry)) {
+                    indices[i].crc32 = entry.crc32;
+                    if(use_cache && !add_cache_entry(entry)) {
+                        console_out_error("Error: Unable to save to cache.");
                     }
                 }
             }
@@ -196,6 +347,144 @@ static void do_crc_things() noexcept {
     }
 }
 
+// Maps are hashed in the background after startup so loading a map only has to look its CRC up. Only the worker thread
+// touches files; results are handed back to the game thread, which updates the map indices and the cache.
+static std::mutex prehashed_maps_mutex;
+static std::vector<CacheEntry> prehashed_maps;
+static std::atomic<bool> prehash_paused(false);
+static std::atomic<bool> prehash_finished(false);
+
+struct PrehashSource {
+    std::string directory;
+    const char *extension;
+};
+
+struct PrehashCandidate {
+    std::string name;
+    std::string path;
+};
+
+// Add each map in source that isn't already in candidates. Earlier candidates win, so sources have to be searched in
+// the same order find_map_file() checks them.
+static void find_prehash_candidates(const PrehashSource &source, std::vector<PrehashCandidate> &candidates) noexcept {
+    const auto &directory = source.directory;
+    const auto &extension = source.extension;
+    WIN32_FIND_DATAA data;
+    auto find = FindFirstFileA((directory + "\\*" + extension).data(), &data);
+    if(find == INVALID_HANDLE_VALUE) return;
+    do {
+        if(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
+        std::string name = data.cFileName;
+        name.erase(name.size() - strlen(extension));
+        if(name.size() >= sizeof(CacheEntry::name)) continue;
+
+        bool found = false;
+        for(auto &candidate : candidates) {
+            if(same_string_case_insensitive(candidate.name.data(), name.data())) {
+                found = true;
+                break;
+            }
+        }
+        if(!found) candidates.push_back(PrehashCandidate { name, directory + "\\" + data.cFileName });
+    } while(FindNextFileA(find, &data));
+    FindClose(find);
+}
+
+static void prehash_maps(std::vector<PrehashSource> sources, std::vector<std::string> known, std::vector<CacheEntry> cached) noexcept {
+    // Lower both CPU and I/O priority so this doesn't get in the way of the game.
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+
+    std::vector<PrehashCandidate> candidates;
+    for(auto &source : sources) {
+        find_prehash_candidates(source, candidates);
+    }
+
+    for(auto &candidate : candidates) {
+        bool is_known = false;
+        for(auto &name : known) {
+            if(same_string_case_insensitive(name.data(), candidate.name.data())) {
+                is_known = true;
+                break;
+            }
+        }
+        if(is_known) continue;
+
+        // Cached entries only need to be checked against the file. Anything that changed gets hashed again.
+        bool is_cached = false;
+        for(auto &entry : cached) {
+            bool updated;
+            if(same_string_case_insensitive(entry.name, candidate.name.data())) {
+                if(validate_cache_entry(entry, candidate.path.data(), updated)) {
+                    is_cached = true;
+                    if(updated) {
+                        std::lock_guard<std::mutex> lock(prehashed_maps_mutex);
+                        prehashed_maps.push_back(entry);
+                    }
+                }
+                break;
+            }
+        }
+        if(is_cached) continue;
+
+        CacheEntry entry;
+        if(make_cache_entry(candidate.name.data(), candidate.path.data(), entry, 1, &prehash_paused)) {
+            std::lock_guard<std::mutex> lock(prehashed_maps_mutex);
+            prehashed_maps.push_back(entry);
+        }
+    }
+
+    prehash_finished = true;
+}
+
+static void prehash_frame() noexcept {
+    // Only hash while in the menu. Any other map means a game is in progress, whether it's multiplayer or campaign.
+    prehash_paused = get_map_header().game_type != MAP_USER_INTERFACE;
+
+    bool finished = prehash_finished;
+    std::vector<CacheEntry> maps;
+    {
+        std::lock_guard<std::mutex> lock(prehashed_maps_mutex);
+        maps.swap(prehashed_maps);
+    }
+
+    auto *indices = map_indices();
+    for(auto &map : maps) {
+        for(size_t i=0;i<maps_count();i++) {
+            if(indices[i].crc32 == 0xFFFFFFFF && same_string_case_insensitive(indices[i].file_name, map.name)) {
+                indices[i].crc32 = map.crc32;
+            }
+        }
+        if(use_cache && !add_cache_entry(map)) {
+            console_out_error("Error: Unable to save to cache.");
+        }
+    }
+
+    if(finished) remove_frame_event(prehash_frame);
+}
+
+void start_map_prehashing() noexcept {
+    static bool started = false;
+    if(started) return;
+    started = true;
+
+    // Everything the worker needs from the game is gathered here.
+    std::vector<PrehashSource> sources;
+    sources.push_back(PrehashSource { "maps", ".map" });
+    if(open_sauce_present()) sources.push_back(PrehashSource { "maps", ".yelo" });
+    if(hac2_present()) sources.push_back(PrehashSource { std::string(halo_path()) + "\\hac\\maps", ".map" });
+
+    std::vector<std::string> known;
+    auto *indices = map_indices();
+    for(size_t i=0;i<maps_count();i++) {
+        if(indices[i].crc32 != 0xFFFFFFFF || (modded_stock_maps && stock_crc32(indices[i].file_name) != 0xFFFFFFFF)) known.emplace_back(indices[i].file_name);
+    }
+    std::vector<CacheEntry> cached;
+    if(use_cache) cached = cache;
+
+    add_frame_event(prehash_frame);
+    std::thread(prehash_maps, std::move(sources), std::move(known), std::move(cached)).detach();
+}
+
 void setup_fast_startup() {
     auto &fast_startup_sig = get_signature("crc32_call_sig");
     auto &get_crc_sig = get_signature("get_crc_sig");
@@ -245,6 +534,7 @@ ChimeraCommandError cache_command(size_t argc, const char **argv) noexcept {
 ChimeraCommandError cache_clear_command(size_t argc, const char **argv) noexcept {
     console_out("Erasing cache...");
     cache.clear();
+    cache_index.clear();
     auto *indices = map_indices();
     for(size_t i=0;i<maps_count();i++) {
         indices[i].crc32 = 0xFFFFFFFF;
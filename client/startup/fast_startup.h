@@ -4,6 +4,14 @@
 
 void setup_fast_startup();
 
+/// Find the file a map is loaded from, writing its path to map_path (which must be at least MAX_PATH). Return false if
+/// the map can't be found.
+bool find_map_file(const char *map_name, char *map_path) noexcept;
+
+/// Start calculating the CRC32 of every installed map that isn't already known in the background. This should be called
+/// once settings are loaded, since it skips maps that are already in the cache.
+void start_map_prehashing() noexcept;
+
 /// Function for command chimera_cache
 ChimeraCommandError cache_command(size_t argc, const char **argv) noexcept;
 
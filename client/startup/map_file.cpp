@@ -0,0 +1,109 @@
+#include <string.h>
+#include <vector>
+#include "map_file.h"
+#include "crc32.h"
+
+// Largest view to map at once. Halo is a 32-bit process, so mapping a whole 300+ MiB map could easily fail.
+#define MAX_VIEW_SIZE (16 * 1024 * 1024)
+
+// Size of the buffer used if the file can't be mapped
+#define BUFFER_SIZE (1024 * 1024)
+
+MapFile::MapFile(const char *path) noexcept {
+    this->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if(this->file == INVALID_HANDLE_VALUE) return;
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(this->file, &size)) {
+        CloseHandle(this->file);
+        this->file = INVALID_HANDLE_VALUE;
+        return;
+    }
+    this->file_size = size.QuadPart;
+
+    // Empty files can't be mapped, but there's also nothing to read.
+    if(this->file_size != 0) {
+        this->mapping = CreateFileMappingA(this->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    this->granularity = info.dwAllocationGranularity;
+}
+
+MapFile::~MapFile() noexcept {
+    if(this->mapping) CloseHandle(this->mapping);
+    if(this->file != INVALID_HANDLE_VALUE) CloseHandle(this->file);
+}
+
+bool MapFile::is_open() const noexcept {
+    return this->file != INVALID_HANDLE_VALUE;
+}
+
+uint64_t MapFile::size() const noexcept {
+    return this->file_size;
+}
+
+bool MapFile::visit(uint64_t offset, uint64_t size, chunk_fn callback, void *user) noexcept {
+    if(!this->is_open() || offset > this->file_size || size > this->file_size - offset) return false;
+    if(!this->mapping) return this->visit_buffered(offset, size, callback, user);
+
+    const auto &granularity = this->granularity;
+    while(size > 0) {
+        // Views have to start on a multiple of the allocation granularity.
+        uint64_t view_offset = offset - offset % granularity;
+        size_t lead = static_cast<size_t>(offset - view_offset);
+        size_t chunk = size > MAX_VIEW_SIZE - lead ? MAX_VIEW_SIZE - lead : static_cast<size_t>(size);
+
+        auto *view = reinterpret_cast<const char *>(MapViewOfFile(this->mapping, FILE_MAP_READ, static_cast<DWORD>(view_offset >> 32), static_cast<DWORD>(view_offset), lead + chunk));
+        if(view) {
+            callback(view + lead, chunk, user);
+            UnmapViewOfFile(view);
+        }
+        else if(!this->visit_buffered(offset, chunk, callback, user)) {
+            return false;
+        }
+
+        offset += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+bool MapFile::visit_buffered(uint64_t offset, uint64_t size, chunk_fn callback, void *user) noexcept {
+    // Each read says where it's reading from rather than moving the file pointer so this can be called from multiple
+    // threads.
+    std::vector<char> buffer(size > BUFFER_SIZE ? BUFFER_SIZE : static_cast<size_t>(size));
+    while(size > 0) {
+        DWORD chunk = size > BUFFER_SIZE ? BUFFER_SIZE : static_cast<DWORD>(size);
+        DWORD bytes_read = 0;
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        if(!ReadFile(this->file, buffer.data(), chunk, &bytes_read, &overlapped) || bytes_read != chunk) return false;
+        callback(buffer.data(), chunk, user);
+        offset += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+static void copy_chunk(const void *data, size_t size, void *user) {
+    auto *&output = *reinterpret_cast<char **>(user);
+    memcpy(output, data, size);
+    output += size;
+}
+
+bool MapFile::read(uint64_t offset, void *output, size_t size) noexcept {
+    auto *position = reinterpret_cast<char *>(output);
+    return this->visit(offset, size, copy_chunk, &position);
+}
+
+static void crc32_chunk(const void *data, size_t size, void *user) {
+    auto &crc = *reinterpret_cast<uint32_t *>(user);
+    crc = ::crc32(crc, data, size);
+}
+
+bool MapFile::crc32(uint32_t &crc, uint64_t offset, uint64_t size) noexcept {
+    return this->visit(offset, size, crc32_chunk, &crc);
+}
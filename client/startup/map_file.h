@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <windows.h>
+
+/// Read-only access to a map file. Data is handed out straight from the page cache through file mapping views, so
+/// regions can be hashed in place without being copied into a buffer first. Views are capped in size so large maps
+/// don't eat up Halo's address space. If the file can't be mapped, it falls back to reading through a small buffer.
+///
+/// Once opened, a MapFile can be read from several threads at once.
+class MapFile {
+public:
+    /// Called for each contiguous piece of a region, in order.
+    typedef void (*chunk_fn)(const void *data, size_t size, void *user);
+
+    /// Open the map file at path. Check is_open() afterwards.
+    MapFile(const char *path) noexcept;
+    ~MapFile() noexcept;
+
+    MapFile(const MapFile &) = delete;
+    MapFile &operator=(const MapFile &) = delete;
+
+    /// Return true if the file was opened.
+    bool is_open() const noexcept;
+
+    /// Get the size of the file in bytes.
+    uint64_t size() const noexcept;
+
+    /// Copy size bytes at offset into output. Return false if the region is out of bounds or can't be read.
+    bool read(uint64_t offset, void *output, size_t size) noexcept;
+
+    /// Call callback for each piece of the region at offset. Return false if the region is out of bounds or can't be
+    /// read, in which case callback may have already been called for part of it.
+    bool visit(uint64_t offset, uint64_t size, chunk_fn callback, void *user) noexcept;
+
+    /// Continue a CRC32 (as calculated by crc32()) over the region at offset.
+    bool crc32(uint32_t &crc, uint64_t offset, uint64_t size) noexcept;
+
+private:
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+    uint64_t file_size = 0;
+    DWORD granularity = 0;
+
+    bool visit_buffered(uint64_t offset, uint64_t size, chunk_fn callback, void *user) noexcept;
+};
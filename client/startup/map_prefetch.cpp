@@ -0,0 +1,54 @@
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "map_prefetch.h"
+#include "map_prefetch_plan.h"
+#include "../../map/map_format.h"
+
+#include "fast_startup.h"
+#include "../client_signature.h"
+#include "../hooks/map_load.h"
+
+// Set when a newer map load supersedes the current prefetch
+static std::mutex prefetch_mutex;
+static std::shared_ptr<std::atomic<bool>> prefetch_cancelled;
+
+static void prefetch_resources(const char *path, const std::vector<ReadAheadRange> &ranges, const std::atomic<bool> *cancelled) noexcept {
+    if(ranges.empty() || *cancelled) return;
+    ReadAheadFile file(path);
+    file.read_ahead(ranges, cancelled);
+}
+
+static void prefetch_map(std::string map_path, std::shared_ptr<std::atomic<bool>> cancelled) noexcept {
+    ReadAheadFile map(map_path.data());
+    MapPrefetchPlan plan;
+    if(!plan_map_prefetch(map, plan)) return;
+
+    // The map's own data is needed first, then the resources.
+    map.read_ahead(plan.map, cancelled.get());
+
+    // Retail maps have their resources moved into chimera\c_bitmaps.map and chimera\c_sounds.map, so they're left alone.
+    if(plan.engine_type == MAP_ENGINE_CUSTOM_EDITION) {
+        prefetch_resources("maps\\bitmaps.map", plan.bitmaps, cancelled.get());
+        prefetch_resources("maps\\sounds.map", plan.sounds, cancelled.get());
+    }
+}
+
+static void on_map_preload() noexcept {
+    static char *loading_map = *reinterpret_cast<char **>(get_signature("loading_map_sig").address() + 1);
+    char map_path[MAX_PATH] = {};
+    if(!find_map_file(loading_map, map_path)) return;
+
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    {
+        std::lock_guard<std::mutex> lock(prefetch_mutex);
+        if(prefetch_cancelled) *prefetch_cancelled = true;
+        prefetch_cancelled = cancelled;
+    }
+    std::thread(prefetch_map, std::string(map_path), cancelled).detach();
+}
+
+void setup_map_prefetch() noexcept {
+    add_map_preload_event(on_map_preload);
+}
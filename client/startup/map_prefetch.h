@@ -0,0 +1,4 @@
+#pragma once
+
+/// Start reading ahead everything a map needs when it begins loading.
+void setup_map_prefetch() noexcept;
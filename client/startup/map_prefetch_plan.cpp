@@ -0,0 +1,48 @@
+#include "map_prefetch_plan.h"
+#include "../../map/tag_data_reader.h"
+
+// Ranges closer together than this are read as one.
+#define PREFETCH_GAP (256 * 1024)
+
+// Add a resource, which is either in the map or in a resource map depending on the external flag.
+static bool add_resource(const MapResource &resource, void *user) noexcept {
+    auto &plan = *reinterpret_cast<MapPrefetchPlan *>(user);
+    auto &ranges = !resource.external ? plan.map : resource.type == MAP_RESOURCE_BITMAP ? plan.bitmaps : plan.sounds;
+    ranges.push_back(ReadAheadRange { resource.offset, resource.size });
+    return true;
+}
+
+static bool read_map(uint64_t offset, void *output, size_t size, void *user) noexcept {
+    return reinterpret_cast<ReadAheadFile *>(user)->read(offset, output, size);
+}
+
+bool plan_map_prefetch(ReadAheadFile &map, MapPrefetchPlan &plan) noexcept {
+    MapHeader header;
+    if(!map.read(0, &header, sizeof(header)) || header.head != 0x68656164 || header.foot != 0x666F6F74 || header.tag_data_size > map.size()) return false;
+    plan.engine_type = header.engine_type;
+
+    // Only the fields needed are read, so how much memory this takes doesn't depend on how big the tag data is.
+    TagDataReader tag_data(header, read_map, &map);
+    MapTagDataHeader tag_data_header;
+    std::vector<MapStructureBSP> bsps;
+    if(!tag_data.header(tag_data_header) || !tag_data.structure_bsps(bsps)) return false;
+
+    // Tag data
+    plan.map.push_back(ReadAheadRange { header.tag_data_offset, header.tag_data_size });
+
+    // BSPs
+    for(auto &bsp : bsps) {
+        plan.map.push_back(ReadAheadRange { bsp.file_offset, bsp.size });
+    }
+
+    // Model data
+    plan.map.push_back(ReadAheadRange { tag_data_header.model_data_offset, tag_data_header.model_data_size });
+
+    // Bitmap and sound data (this fails if the tag array can't be read)
+    if(!tag_data.for_each_resource(add_resource, &plan)) return false;
+
+    coalesce_read_ahead_ranges(plan.map, PREFETCH_GAP);
+    coalesce_read_ahead_ranges(plan.bitmaps, PREFETCH_GAP);
+    coalesce_read_ahead_ranges(plan.sounds, PREFETCH_GAP);
+    return true;
+}
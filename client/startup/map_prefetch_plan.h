@@ -0,0 +1,23 @@
+#pragma once
+
+#include "read_ahead.h"
+
+/// Everything worth reading ahead for a map, split up by the file it's in. This doesn't depend on anything in Halo, so
+/// it can be used on any map file.
+struct MapPrefetchPlan {
+    /// Engine type from the map header (7 for retail, 0x261 for Custom Edition)
+    uint32_t engine_type = 0;
+
+    /// Ranges in the map itself: tag data, BSPs, model data, and any bitmap and sound data stored in the map
+    std::vector<ReadAheadRange> map;
+
+    /// Ranges in bitmaps.map
+    std::vector<ReadAheadRange> bitmaps;
+
+    /// Ranges in sounds.map
+    std::vector<ReadAheadRange> sounds;
+};
+
+/// Read the map's header and the parts of its tag data that point to other data, and work out what it'll need. Ranges are
+/// sorted and coalesced. Return false if the map isn't valid.
+bool plan_map_prefetch(ReadAheadFile &map, MapPrefetchPlan &plan) noexcept;
@@ -0,0 +1,234 @@
+// Plan prefetches for small synthetic maps and check that the plan covers what each map references, that the tag data
+// reader finds the same resources as a view of the whole tag data, and that broken maps are rejected.
+//
+// Usage: map_prefetch_plan_test
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "map_prefetch_plan.h"
+#include "../../map/tag_data_view.h"
+
+#define TEST_MAP_PATH "map_prefetch_plan_test.map"
+
+// Where everything goes in the synthetic tag data, relative to MAP_TAG_DATA_ADDRESS
+#define TAG_ARRAY 0x40
+#define SCENARIO_DATA 0x100
+#define SCENARIO_BSPS 0x700
+#define BITMAP_DATA 0x800
+#define BITMAP_ENTRIES 0x900
+#define SOUND_DATA 0xA00
+#define SOUND_PITCH_RANGES 0xB00
+#define SOUND_PERMUTATIONS 0xC00
+#define TAG_DATA_SIZE 0x1000
+
+#define TAG_DATA_OFFSET 0x800
+#define FILE_SIZE 0x400000
+
+struct TestMap {
+    MapHeader header = {};
+    std::vector<char> tag_data = std::vector<char>(TAG_DATA_SIZE);
+
+    template<typename T> T &at(uint32_t offset) noexcept {
+        return *reinterpret_cast<T *>(this->tag_data.data() + offset);
+    }
+
+    void set_reflexive(uint32_t offset, uint32_t count, uint32_t address) noexcept {
+        auto &reflexive = this->at<MapReflexive>(offset);
+        reflexive.count = count;
+        reflexive.address = MAP_TAG_DATA_ADDRESS + address;
+    }
+
+    void set_tag(uint32_t index, uint32_t tag_class, uint32_t data) noexcept {
+        auto &tag = this->at<MapTag>(TAG_ARRAY + index * sizeof(MapTag));
+        tag.tag_class = tag_class;
+        tag.tag_id = 0xE0000000 + index;
+        tag.data = MAP_TAG_DATA_ADDRESS + data;
+    }
+
+    void set_bitmap(uint32_t index, bool external, uint32_t offset, uint32_t size) noexcept {
+        auto *bitmap = this->tag_data.data() + BITMAP_ENTRIES + index * MAP_BITMAP_DATA_SIZE;
+        bitmap[0xF] = external ? 1 : 0;
+        *reinterpret_cast<uint32_t *>(bitmap + 0x18) = offset;
+        *reinterpret_cast<uint32_t *>(bitmap + 0x1C) = size;
+    }
+
+    void set_sound(uint32_t index, bool external, uint32_t offset, uint32_t size) noexcept {
+        auto *permutation = this->tag_data.data() + SOUND_PERMUTATIONS + index * MAP_SOUND_PERMUTATION_SIZE;
+        *reinterpret_cast<uint32_t *>(permutation + 0x40) = size;
+        permutation[0x44] = external ? 1 : 0;
+        *reinterpret_cast<uint32_t *>(permutation + 0x48) = offset;
+    }
+
+    /// Make a map with a scenario with two BSPs, a bitmap tag with two bitmaps, and a sound tag with two permutations.
+    /// One of each resource is in the map and the other is in bitmaps.map or sounds.map.
+    TestMap() noexcept {
+        this->header.engine_type = MAP_ENGINE_CUSTOM_EDITION;
+        this->header.file_size = FILE_SIZE;
+        this->header.tag_data_offset = TAG_DATA_OFFSET;
+        this->header.tag_data_size = TAG_DATA_SIZE;
+        strcpy(this->header.name, "test");
+
+        auto &tag_data_header = this->at<MapTagDataHeader>(0);
+        tag_data_header.tag_array = MAP_TAG_DATA_ADDRESS + TAG_ARRAY;
+        tag_data_header.scenario_tag_id = 0xE0000000;
+        tag_data_header.tag_count = 3;
+        tag_data_header.model_data_offset = 0x100000;
+        tag_data_header.model_data_size = 0x20000;
+        tag_data_header.tags = 0x74616773;
+
+        this->set_tag(0, MAP_TAG_CLASS_SCENARIO, SCENARIO_DATA);
+        this->set_tag(1, MAP_TAG_CLASS_BITMAP, BITMAP_DATA);
+        this->set_tag(2, MAP_TAG_CLASS_SOUND, SOUND_DATA);
+
+        this->set_reflexive(SCENARIO_DATA + MAP_SCENARIO_STRUCTURE_BSPS, 2, SCENARIO_BSPS);
+        auto *bsps = &this->at<MapStructureBSP>(SCENARIO_BSPS);
+        bsps[0].file_offset = 0x10000;
+        bsps[0].size = 0x8000;
+        bsps[1].file_offset = 0x40000;
+        bsps[1].size = 0x1000;
+
+        this->set_reflexive(BITMAP_DATA + MAP_BITMAP_DATA, 2, BITMAP_ENTRIES);
+        this->set_bitmap(0, false, 0x200000, 0x100);
+        this->set_bitmap(1, true, 0x5000, 0x200);
+
+        this->set_reflexive(SOUND_DATA + MAP_SOUND_PITCH_RANGES, 1, SOUND_PITCH_RANGES);
+        this->set_reflexive(SOUND_PITCH_RANGES + MAP_SOUND_PERMUTATIONS, 2, SOUND_PERMUTATIONS);
+        this->set_sound(0, false, 0x300000, 0x4000);
+        this->set_sound(1, true, 0x7000, 0x300);
+    }
+
+    /// Write the map, padded out to FILE_SIZE. Return false if it can't be written.
+    bool write(const char *path) const noexcept {
+        FILE *f = fopen(path, "wb");
+        if(!f) return false;
+        bool written = fwrite(&this->header, sizeof(this->header), 1, f) == 1 &&
+                       fseek(f, TAG_DATA_OFFSET, SEEK_SET) == 0 &&
+                       fwrite(this->tag_data.data(), this->tag_data.size(), 1, f) == 1 &&
+                       fseek(f, FILE_SIZE - 1, SEEK_SET) == 0 &&
+                       fputc(0, f) == 0;
+        return fclose(f) == 0 && written;
+    }
+};
+
+static size_t failures = 0;
+
+static void check(bool condition, const char *test, const char *what) noexcept {
+    if(!condition) {
+        fprintf(stderr, "%s: %s\n", test, what);
+        failures++;
+    }
+}
+
+static bool plan(const TestMap &map, MapPrefetchPlan &plan) noexcept {
+    if(!map.write(TEST_MAP_PATH)) {
+        fprintf(stderr, "Can't write %s\n", TEST_MAP_PATH);
+        return false;
+    }
+    ReadAheadFile file(TEST_MAP_PATH);
+    return file.is_open() && plan_map_prefetch(file, plan);
+}
+
+static bool ranges_match(const std::vector<ReadAheadRange> &ranges, const std::vector<ReadAheadRange> &expected) noexcept {
+    if(ranges.size() != expected.size()) return false;
+    for(size_t r=0;r<ranges.size();r++) {
+        if(ranges[r].offset != expected[r].offset || ranges[r].size != expected[r].size) return false;
+    }
+    return true;
+}
+
+static bool add_range(const MapResource &resource, void *user) noexcept {
+    auto &ranges = *reinterpret_cast<std::vector<ReadAheadRange> *>(user);
+    ranges.push_back(ReadAheadRange { resource.offset, resource.size });
+    return true;
+}
+
+static void test_valid_map() noexcept {
+    const char *test = "valid map";
+    TestMap map;
+    MapPrefetchPlan result;
+    if(!plan(map, result)) {
+        check(false, test, "not planned");
+        return;
+    }
+    check(result.engine_type == MAP_ENGINE_CUSTOM_EDITION, test, "wrong engine type");
+
+    // The tag data and both BSPs are close enough together to be read as one range. Model data and the resources in
+    // the map are too far from each other and from the BSPs to be merged.
+    check(ranges_match(result.map, {
+        { TAG_DATA_OFFSET, 0x41000 - TAG_DATA_OFFSET },
+        { 0x100000, 0x20000 },
+        { 0x200000, 0x100 },
+        { 0x300000, 0x4000 }
+    }), test, "wrong map ranges");
+    check(ranges_match(result.bitmaps, { { 0x5000, 0x200 } }), test, "wrong bitmaps.map ranges");
+    check(ranges_match(result.sounds, { { 0x7000, 0x300 } }), test, "wrong sounds.map ranges");
+
+    // Anything the planner finds by reading fields should be exactly what's found with all of the tag data in memory.
+    std::vector<ReadAheadRange> expected;
+    TagDataView(map.tag_data.data(), map.tag_data.size()).for_each_resource(add_range, &expected);
+    std::vector<ReadAheadRange> found = result.map;
+    found.insert(found.end(), result.bitmaps.begin(), result.bitmaps.end());
+    found.insert(found.end(), result.sounds.begin(), result.sounds.end());
+    for(auto &range : expected) {
+        bool covered = false;
+        for(auto &f : found) {
+            covered = covered || (range.offset >= f.offset && range.offset + range.size <= f.offset + f.size);
+        }
+        check(covered, test, "resource found by TagDataView is missing from the plan");
+    }
+    check(expected.size() == 4, test, "TagDataView found the wrong number of resources");
+}
+
+static void test_invalid_maps() noexcept {
+    MapPrefetchPlan result;
+    {
+        TestMap map;
+        map.header.head = 0;
+        check(!plan(map, result), "bad header", "planned anyway");
+    }
+    {
+        TestMap map;
+        map.header.tag_data_size = FILE_SIZE + 1;
+        check(!plan(map, result), "tag data bigger than the file", "planned anyway");
+    }
+    {
+        TestMap map;
+        map.at<MapTagDataHeader>(0).tag_count = 0x7FFFFFFF;
+        check(!plan(map, result), "tag array out of bounds", "planned anyway");
+    }
+    {
+        TestMap map;
+        map.set_reflexive(SCENARIO_DATA + MAP_SCENARIO_STRUCTURE_BSPS, 2, TAG_DATA_SIZE - 0x20);
+        check(!plan(map, result), "BSPs out of bounds", "planned anyway");
+    }
+}
+
+static void test_broken_resources() noexcept {
+    const char *test = "broken resources";
+
+    // Resources that can't be read are skipped without failing the whole plan (or trying to allocate for them).
+    TestMap map;
+    map.set_reflexive(BITMAP_DATA + MAP_BITMAP_DATA, 0xFFFFFFFF, BITMAP_ENTRIES);
+    map.set_reflexive(SOUND_PITCH_RANGES + MAP_SOUND_PERMUTATIONS, 2, TAG_DATA_SIZE - 0x10);
+    MapPrefetchPlan result;
+    if(!plan(map, result)) {
+        check(false, test, "not planned");
+        return;
+    }
+    check(ranges_match(result.map, {
+        { TAG_DATA_OFFSET, 0x41000 - TAG_DATA_OFFSET },
+        { 0x100000, 0x20000 }
+    }), test, "wrong map ranges");
+    check(result.bitmaps.empty() && result.sounds.empty(), test, "resource ranges found");
+}
+
+int main() {
+    test_valid_map();
+    test_invalid_maps();
+    test_broken_resources();
+    remove(TEST_MAP_PATH);
+
+    printf("%zu failures\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,383 @@
+// Check the perfect hash lookups against the comparison chains they replaced, on every key and on strings that are
+// close to a key without being one.
+//
+// Usage: perfect_hash_test
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "stock_crc32.h"
+#include "../halo_data/tiarace/hce_tag_class_int.h"
+
+using namespace HaloCE;
+
+// The functions the tables replaced, copied as they were apart from their names
+
+static uint32_t old_stock_crc32(const std::string &name) noexcept {
+    if(name == "beavercreek")
+        return 0x07B3876A;
+    else if(name == "sidewinder")
+        return 0xBD95CF55;
+    else if(name == "damnation")
+        return 0x0FBA059D;
+    else if(name == "ratrace")
+        return 0xF7F8E14C;
+    else if(name == "prisoner")
+        return 0x43B81A8B;
+    else if(name == "hangemhigh")
+        return 0xA7C8B9C6;
+    else if(name == "chillout")
+        return 0x93C53C27;
+    else if(name == "carousel")
+        return 0x9C301A08;
+    else if(name == "boardingaction")
+        return 0xF4DEEF94;
+    else if(name == "bloodgulch")
+        return 0x7B309554;
+    else if(name == "wizard")
+        return 0xCF3359B1;
+    else if(name == "putput")
+        return 0xAF2F0B84;
+    else if(name == "longest")
+        return 0xC8F48FF6;
+    else if(name == "dangercanyon")
+        return 0xC410CD74;
+    else if(name == "deathisland")
+        return 0x1DF8C97F;
+    else if(name == "gephyrophobia")
+        return 0xD2872165;
+    else if(name == "infinity")
+        return 0x0E7F7FE7;
+    else if(name == "timberland")
+        return 0x54446470;
+    else if(name == "icefields")
+        return 0x5EC1DEB7;
+    else
+        return 0xFFFFFFFF;
+}
+
+static TagClassInt old_tag_class_int_from_string(const char *i) noexcept {
+    if (strcmp(i, "actor") == 0)
+        return TAG_CLASS_INT_ACTOR;
+    else if (strcmp(i, "actor_variant") == 0)
+        return TAG_CLASS_INT_ACTOR_VARIANT;
+    else if (strcmp(i, "antenna") == 0)
+        return TAG_CLASS_INT_ANTENNA;
+    else if (strcmp(i, "model_animations") == 0)
+        return TAG_CLASS_INT_MODEL_ANIMATIONS;
+    else if (strcmp(i, "biped") == 0)
+        return TAG_CLASS_INT_BIPED;
+    else if (strcmp(i, "bitmap") == 0)
+        return TAG_CLASS_INT_BITMAP;
+    else if (strcmp(i, "spheroid") == 0)
+        return TAG_CLASS_INT_SPHEROID;
+    else if (strcmp(i, "continuous_damage_effect") == 0)
+        return TAG_CLASS_INT_CONTINUOUS_DAMAGE_EFFECT;
+    else if (strcmp(i, "model_collision_geometry") == 0)
+        return TAG_CLASS_INT_MODEL_COLLISION_GEOMETRY;
+    else if (strcmp(i, "color_table") == 0)
+        return TAG_CLASS_INT_COLOR_TABLE;
+    else if (strcmp(i, "contrail") == 0)
+        return TAG_CLASS_INT_CONTRAIL;
+    else if (strcmp(i, "device_control") == 0)
+        return TAG_CLASS_INT_DEVICE_CONTROL;
+    else if (strcmp(i, "decal") == 0)
+        return TAG_CLASS_INT_DECAL;
+    else if (strcmp(i, "ui_widget_definition") == 0)
+        return TAG_CLASS_INT_UI_WIDGET_DEFINITION;
+    else if (strcmp(i, "input_device_defaults") == 0)
+        return TAG_CLASS_INT_INPUT_DEVICE_DEFAULTS;
+    else if (strcmp(i, "device") == 0)
+        return TAG_CLASS_INT_DEVICE;
+    else if (strcmp(i, "detail_object_collection") == 0)
+        return TAG_CLASS_INT_DETAIL_OBJECT_COLLECTION;
+    else if (strcmp(i, "effect") == 0)
+        return TAG_CLASS_INT_EFFECT;
+    else if (strcmp(i, "equipment") == 0)
+        return TAG_CLASS_INT_EQUIPMENT;
+    else if (strcmp(i, "flag") == 0)
+        return TAG_CLASS_INT_FLAG;
+    else if (strcmp(i, "fog") == 0)
+        return TAG_CLASS_INT_FOG;
+    else if (strcmp(i, "font") == 0)
+        return TAG_CLASS_INT_FONT;
+    else if (strcmp(i, "lightning") == 0)
+        return TAG_CLASS_INT_LIGHTNING;
+    else if (strcmp(i, "material_effects") == 0)
+        return TAG_CLASS_INT_MATERIAL_EFFECTS;
+    else if (strcmp(i, "garbage") == 0)
+        return TAG_CLASS_INT_GARBAGE;
+    else if (strcmp(i, "glow") == 0)
+        return TAG_CLASS_INT_GLOW;
+    else if (strcmp(i, "grenade_hud_interface") == 0)
+        return TAG_CLASS_INT_GRENADE_HUD_INTERFACE;
+    else if (strcmp(i, "hud_message_text") == 0)
+        return TAG_CLASS_INT_HUD_MESSAGE_TEXT;
+    else if (strcmp(i, "hud_number") == 0)
+        return TAG_CLASS_INT_HUD_NUMBER;
+    else if (strcmp(i, "hud_globals") == 0)
+        return TAG_CLASS_INT_HUD_GLOBALS;
+    else if (strcmp(i, "item") == 0)
+        return TAG_CLASS_INT_ITEM;
+    else if (strcmp(i, "item_collection") == 0)
+        return TAG_CLASS_INT_ITEM_COLLECTION;
+    else if (strcmp(i, "damage_effect") == 0)
+        return TAG_CLASS_INT_DAMAGE_EFFECT;
+    else if (strcmp(i, "lens_flare") == 0)
+        return TAG_CLASS_INT_LENS_FLARE;
+    else if (strcmp(i, "device_light_fixture") == 0)
+        return TAG_CLASS_INT_DEVICE_LIGHT_FIXTURE;
+    else if (strcmp(i, "light") == 0)
+        return TAG_CLASS_INT_LIGHT;
+    else if (strcmp(i, "sound_looping") == 0)
+        return TAG_CLASS_INT_SOUND_LOOPING;
+    else if (strcmp(i, "device_machine") == 0)
+        return TAG_CLASS_INT_DEVICE_MACHINE;
+    else if (strcmp(i, "globals") == 0)
+        return TAG_CLASS_INT_GLOBALS;
+    else if (strcmp(i, "meter") == 0)
+        return TAG_CLASS_INT_METER;
+    else if (strcmp(i, "light_volume") == 0)
+        return TAG_CLASS_INT_LIGHT_VOLUME;
+    else if (strcmp(i, "gbxmodel") == 0)
+        return TAG_CLASS_INT_GBXMODEL;
+    else if (strcmp(i, "model") == 0)
+        return TAG_CLASS_INT_MODEL;
+    else if (strcmp(i, "multiplayer_scenario_description") == 0)
+        return TAG_CLASS_INT_MULTIPLAYER_SCENARIO_DESCRIPTION;
+    else if (strcmp(i, "preferences_network_game") == 0)
+        return TAG_CLASS_INT_PREFERENCES_NETWORK_GAME;
+    else if (strcmp(i, "object") == 0)
+        return TAG_CLASS_INT_OBJECT;
+    else if (strcmp(i, "particle") == 0)
+        return TAG_CLASS_INT_PARTICLE;
+    else if (strcmp(i, "particle_system") == 0)
+        return TAG_CLASS_INT_PARTICLE_SYSTEM;
+    else if (strcmp(i, "physics") == 0)
+        return TAG_CLASS_INT_PHYSICS;
+    else if (strcmp(i, "placeholder") == 0)
+        return TAG_CLASS_INT_PLACEHOLDER;
+    else if (strcmp(i, "point_physics") == 0)
+        return TAG_CLASS_INT_POINT_PHYSICS;
+    else if (strcmp(i, "projectile") == 0)
+        return TAG_CLASS_INT_PROJECTILE;
+    else if (strcmp(i, "weather") == 0)
+        return TAG_CLASS_INT_WEATHER;
+    else if (strcmp(i, "scenario_structure_bsp") == 0)
+        return TAG_CLASS_INT_SCENARIO_STRUCTURE_BSP;
+    else if (strcmp(i, "scenery") == 0)
+        return TAG_CLASS_INT_SCENERY;
+    else if (strcmp(i, "shader_transparent_chicago_extended") == 0)
+        return TAG_CLASS_INT_SHADER_TRANSPARENT_CHICAGO_EXTENDED;
+    else if (strcmp(i, "shader_transparent_chicago") == 0)
+        return TAG_CLASS_INT_SHADER_TRANSPARENT_CHICAGO;
+    else if (strcmp(i, "scenario") == 0)
+        return TAG_CLASS_INT_SCENARIO;
+    else if (strcmp(i, "shader_environment") == 0)
+        return TAG_CLASS_INT_SHADER_ENVIRONMENT;
+    else if (strcmp(i, "transparent_glass") == 0)
+        return TAG_CLASS_INT_SHADER_TRANSPARENT_GLASS;
+    else if (strcmp(i, "shader") == 0)
+        return TAG_CLASS_INT_SHADER;
+    else if (strcmp(i, "sky") == 0)
+        return TAG_CLASS_INT_SKY;
+    else if (strcmp(i, "shader_transparent_meter") == 0)
+        return TAG_CLASS_INT_SHADER_TRANSPARENT_METER;
+    else if (strcmp(i, "sound") == 0)
+        return TAG_CLASS_INT_SOUND;
+    else if (strcmp(i, "sound_environment") == 0)
+        return TAG_CLASS_INT_SOUND_ENVIRONMENT;
+    else if (strcmp(i, "shader_model") == 0)
+        return TAG_CLASS_INT_SHADER_MODEL;
+    else if (strcmp(i, "shader_transparent_generic") == 0)
+        return TAG_CLASS_INT_SHADER_TRANSPARENT_GENERIC;
+    else if (strcmp(i, "ui_widget_collection") == 0)
+        return TAG_CLASS_INT_UI_WIDGET_COLLECTION;
+    else if (strcmp(i, "shader_transparent_plasma") == 0)
+        return TAG_CLASS_INT_SHADER_TRANSPARENT_PLASMA;
+    else if (strcmp(i, "sound_scenery") == 0)
+        return TAG_CLASS_INT_SOUND_SCENERY;
+    else if (strcmp(i, "string_list") == 0)
+        return TAG_CLASS_INT_STRING_LIST;
+    else if (strcmp(i, "shader_transparent_water") == 0)
+        return TAG_CLASS_INT_SHADER_TRANSPARENT_WATER;
+    else if (strcmp(i, "tag_collection") == 0)
+        return TAG_CLASS_INT_TAG_COLLECTION;
+    else if (strcmp(i, "camera_track") == 0)
+        return TAG_CLASS_INT_CAMERA_TRACK;
+    else if (strcmp(i, "unit_dialogue") == 0)
+        return TAG_CLASS_INT_UNIT_DIALOGUE;
+    else if (strcmp(i, "unit_hud_interface") == 0)
+        return TAG_CLASS_INT_UNIT_HUD_INTERFACE;
+    else if (strcmp(i, "unit") == 0)
+        return TAG_CLASS_INT_UNIT;
+    else if (strcmp(i, "unicode_string_list") == 0)
+        return TAG_CLASS_INT_UNICODE_STRING_LIST;
+    else if (strcmp(i, "virtual_keyboard") == 0)
+        return TAG_CLASS_INT_VIRTUAL_KEYBOARD;
+    else if (strcmp(i, "vehicle") == 0)
+        return TAG_CLASS_INT_VEHICLE;
+    else if (strcmp(i, "weapon") == 0)
+        return TAG_CLASS_INT_WEAPON;
+    else if (strcmp(i, "wind") == 0)
+        return TAG_CLASS_INT_WIND;
+    else if (strcmp(i, "weapon_hud_interface") == 0)
+        return TAG_CLASS_INT_WEAPON_HUD_INTERFACE;
+    else
+        return TAG_CLASS_INT_NONE;
+}
+
+// Every key of the old tag class chain
+static const char *tag_class_keys[] = {
+    "actor",
+    "actor_variant",
+    "antenna",
+    "model_animations",
+    "biped",
+    "bitmap",
+    "spheroid",
+    "continuous_damage_effect",
+    "model_collision_geometry",
+    "color_table",
+    "contrail",
+    "device_control",
+    "decal",
+    "ui_widget_definition",
+    "input_device_defaults",
+    "device",
+    "detail_object_collection",
+    "effect",
+    "equipment",
+    "flag",
+    "fog",
+    "font",
+    "lightning",
+    "material_effects",
+    "garbage",
+    "glow",
+    "grenade_hud_interface",
+    "hud_message_text",
+    "hud_number",
+    "hud_globals",
+    "item",
+    "item_collection",
+    "damage_effect",
+    "lens_flare",
+    "device_light_fixture",
+    "light",
+    "sound_looping",
+    "device_machine",
+    "globals",
+    "meter",
+    "light_volume",
+    "gbxmodel",
+    "model",
+    "multiplayer_scenario_description",
+    "preferences_network_game",
+    "object",
+    "particle",
+    "particle_system",
+    "physics",
+    "placeholder",
+    "point_physics",
+    "projectile",
+    "weather",
+    "scenario_structure_bsp",
+    "scenery",
+    "shader_transparent_chicago_extended",
+    "shader_transparent_chicago",
+    "scenario",
+    "shader_environment",
+    "transparent_glass",
+    "shader",
+    "sky",
+    "shader_transparent_meter",
+    "sound",
+    "sound_environment",
+    "shader_model",
+    "shader_transparent_generic",
+    "ui_widget_collection",
+    "shader_transparent_plasma",
+    "sound_scenery",
+    "string_list",
+    "shader_transparent_water",
+    "tag_collection",
+    "camera_track",
+    "unit_dialogue",
+    "unit_hud_interface",
+    "unit",
+    "unicode_string_list",
+    "virtual_keyboard",
+    "vehicle",
+    "weapon",
+    "wind",
+    "weapon_hud_interface"
+};
+
+static size_t checked = 0;
+static size_t failures = 0;
+
+static void check(const std::string &key) noexcept {
+    checked++;
+    uint32_t stock_expected = old_stock_crc32(key);
+    uint32_t stock_actual = stock_crc32(key.data());
+    if(stock_expected != stock_actual) {
+        fprintf(stderr, "stock_crc32(\"%s\"): expected 0x%08X, got 0x%08X\n", key.data(), stock_expected, stock_actual);
+        failures++;
+    }
+    auto tag_expected = old_tag_class_int_from_string(key.data());
+    auto tag_actual = tag_class_int_from_string(key.data());
+    if(tag_expected != tag_actual) {
+        fprintf(stderr, "tag_class_int_from_string(\"%s\"): expected 0x%08X, got 0x%08X\n", key.data(), tag_expected, tag_actual);
+        failures++;
+    }
+}
+
+// Check a key along with every string that differs from it by one character.
+static void check_with_near_misses(const std::string &key) noexcept {
+    check(key);
+    check(key + "x");
+    check(key + " ");
+    if(!key.empty()) {
+        check(key.substr(0, key.size() - 1));
+        check(key.substr(1));
+    }
+    for(size_t i = 0; i < key.size(); i++) {
+        auto changed = key;
+        changed[i] ^= 0x20;
+        check(changed);
+        changed[i] = key[i] + 1;
+        check(changed);
+    }
+}
+
+int main() {
+    std::vector<std::string> keys;
+    for(auto &entry : stock_crc32s) {
+        keys.push_back(entry.key);
+    }
+
+    for(auto *key : tag_class_keys) {
+        keys.push_back(key);
+        auto tag_class = tag_class_int_from_string(key);
+        if(strcmp(tag_class_string_from_int(tag_class), key) != 0) {
+            fprintf(stderr, "%s does not round trip\n", key);
+            failures++;
+        }
+    }
+
+    keys.push_back("");
+    keys.push_back("none");
+    keys.push_back("unknown");
+    keys.push_back("ui");
+    keys.push_back("a30");
+    keys.push_back("bloodgulch.map");
+
+    for(auto &key : keys) {
+        check_with_near_misses(key);
+    }
+
+    printf("%zu strings checked, %zu mismatches\n", checked, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include "read_ahead.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+void coalesce_read_ahead_ranges(std::vector<ReadAheadRange> &ranges, uint64_t gap) noexcept {
+    std::sort(ranges.begin(), ranges.end(), [](const ReadAheadRange &a, const ReadAheadRange &b) {
+        return a.offset < b.offset;
+    });
+
+    size_t count = 0;
+    for(auto &range : ranges) {
+        if(range.size == 0) continue;
+        if(count > 0) {
+            auto &last = ranges[count - 1];
+            uint64_t last_end = last.offset + last.size;
+            if(range.offset <= last_end || range.offset - last_end < gap) {
+                uint64_t end = range.offset + range.size;
+                if(end > last_end) last.size = end - last.offset;
+                continue;
+            }
+        }
+        ranges[count++] = range;
+    }
+    ranges.resize(count);
+}
+
+#ifdef _WIN32
+
+// Reads in flight at once and how big each one is
+#define READ_AHEAD_DEPTH 4
+#define READ_AHEAD_CHUNK_SIZE (1024 * 1024)
+
+ReadAheadFile::ReadAheadFile(const char *path) noexcept {
+    this->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+    if(this->file == INVALID_HANDLE_VALUE) return;
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(this->file, &size)) {
+        CloseHandle(this->file);
+        this->file = INVALID_HANDLE_VALUE;
+        return;
+    }
+    this->file_size = size.QuadPart;
+}
+
+ReadAheadFile::~ReadAheadFile() noexcept {
+    if(this->file != INVALID_HANDLE_VALUE) CloseHandle(this->file);
+}
+
+bool ReadAheadFile::is_open() const noexcept {
+    return this->file != INVALID_HANDLE_VALUE;
+}
+
+// Start an overlapped read. Return false if it failed outright.
+static bool start_read(HANDLE file, uint64_t offset, void *output, DWORD size, OVERLAPPED &overlapped) noexcept {
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    return ReadFile(file, output, size, NULL, &overlapped) || GetLastError() == ERROR_IO_PENDING;
+}
+
+bool ReadAheadFile::read(uint64_t offset, void *output, size_t size) noexcept {
+    if(!this->is_open() || offset > this->file_size || size > this->file_size - offset) return false;
+
+    OVERLAPPED overlapped = {};
+    overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if(!overlapped.hEvent) return false;
+
+    auto *data = reinterpret_cast<char *>(output);
+    bool success = true;
+    while(size > 0 && success) {
+        DWORD chunk = size > READ_AHEAD_CHUNK_SIZE ? READ_AHEAD_CHUNK_SIZE : static_cast<DWORD>(size);
+        DWORD bytes_read = 0;
+        success = start_read(this->file, offset, data, chunk, overlapped) && GetOverlappedResult(this->file, &overlapped, &bytes_read, TRUE) && bytes_read == chunk;
+        offset += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+
+    CloseHandle(overlapped.hEvent);
+    return success;
+}
+
+void ReadAheadFile::read_ahead(const std::vector<ReadAheadRange> &ranges, const std::atomic<bool> *cancel) noexcept {
+    if(!this->is_open()) return;
+
+    struct PendingRead {
+        OVERLAPPED overlapped;
+        bool active;
+    } reads[READ_AHEAD_DEPTH] = {};
+    std::vector<char> buffer(READ_AHEAD_DEPTH * READ_AHEAD_CHUNK_SIZE);
+    for(auto &read : reads) {
+        read.overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+    }
+
+    // Wait for a read slot to be free. The data itself isn't needed.
+    auto finish = [this](PendingRead &read) {
+        if(!read.active) return;
+        DWORD bytes_read;
+        GetOverlappedResult(this->file, &read.overlapped, &bytes_read, TRUE);
+        read.active = false;
+    };
+
+    size_t next = 0;
+    for(auto &range : ranges) {
+        if(range.offset >= this->file_size) continue;
+        uint64_t end = range.size > this->file_size - range.offset ? this->file_size : range.offset + range.size;
+        for(uint64_t offset = range.offset; offset < end && !(cancel && *cancel); offset += READ_AHEAD_CHUNK_SIZE) {
+            auto &read = reads[next];
+            finish(read);
+            if(!read.overlapped.hEvent) continue;
+            DWORD chunk = end - offset > READ_AHEAD_CHUNK_SIZE ? READ_AHEAD_CHUNK_SIZE : static_cast<DWORD>(end - offset);
+            read.active = start_read(this->file, offset, buffer.data() + next * READ_AHEAD_CHUNK_SIZE, chunk, read.overlapped);
+            next = (next + 1) % READ_AHEAD_DEPTH;
+        }
+    }
+
+    for(auto &read : reads) {
+        finish(read);
+        if(read.overlapped.hEvent) CloseHandle(read.overlapped.hEvent);
+    }
+}
+
+#else
+
+ReadAheadFile::ReadAheadFile(const char *path) noexcept {
+    this->file = open(path, O_RDONLY);
+    if(this->file == -1) return;
+
+    struct stat s;
+    if(fstat(this->file, &s) != 0) {
+        close(this->file);
+        this->file = -1;
+        return;
+    }
+    this->file_size = s.st_size;
+}
+
+ReadAheadFile::~ReadAheadFile() noexcept {
+    if(this->file != -1) close(this->file);
+}
+
+bool ReadAheadFile::is_open() const noexcept {
+    return this->file != -1;
+}
+
+bool ReadAheadFile::read(uint64_t offset, void *output, size_t size) noexcept {
+    if(!this->is_open() || offset > this->file_size || size > this->file_size - offset) return false;
+
+    auto *data = reinterpret_cast<char *>(output);
+    while(size > 0) {
+        auto bytes_read = pread(this->file, data, size, offset);
+        if(bytes_read <= 0) return false;
+        offset += bytes_read;
+        data += bytes_read;
+        size -= bytes_read;
+    }
+    return true;
+}
+
+void ReadAheadFile::read_ahead(const std::vector<ReadAheadRange> &ranges, const std::atomic<bool> *cancel) noexcept {
+    if(!this->is_open()) return;
+    for(auto &range : ranges) {
+        if(cancel && *cancel) return;
+        if(range.offset >= this->file_size) continue;
+        uint64_t size = range.size > this->file_size - range.offset ? this->file_size - range.offset : range.size;
+        posix_fadvise(this->file, range.offset, size, POSIX_FADV_WILLNEED);
+    }
+}
+
+#endif
+
+uint64_t ReadAheadFile::size() const noexcept {
+    return this->file_size;
+}
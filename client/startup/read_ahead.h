@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+struct ReadAheadRange {
+    uint64_t offset;
+    uint64_t size;
+};
+
+/// Sort ranges and merge any that overlap or are less than gap bytes apart, so the disk gets a few long requests instead
+/// of many small ones.
+void coalesce_read_ahead_ranges(std::vector<ReadAheadRange> &ranges, uint64_t gap) noexcept;
+
+/// A file that can be read from directly and asked to pull ranges into the OS cache ahead of time.
+///
+/// On Windows, ranges are read with several overlapped reads in flight and the data is thrown away. Elsewhere,
+/// posix_fadvise() is used, which returns immediately.
+class ReadAheadFile {
+public:
+    /// Open the file at path. Check is_open() afterwards.
+    ReadAheadFile(const char *path) noexcept;
+    ~ReadAheadFile() noexcept;
+
+    ReadAheadFile(const ReadAheadFile &) = delete;
+    ReadAheadFile &operator=(const ReadAheadFile &) = delete;
+
+    /// Return true if the file was opened.
+    bool is_open() const noexcept;
+
+    /// Get the size of the file in bytes.
+    uint64_t size() const noexcept;
+
+    /// Copy size bytes at offset into output. Return false if the region is out of bounds or can't be read.
+    bool read(uint64_t offset, void *output, size_t size) noexcept;
+
+    /// Ask for ranges to be cached. Ranges are clamped to the file. If cancel is set, this stops as soon as it's true.
+    void read_ahead(const std::vector<ReadAheadRange> &ranges, const std::atomic<bool> *cancel = nullptr) noexcept;
+
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+#else
+    int file = -1;
+#endif
+    uint64_t file_size = 0;
+};
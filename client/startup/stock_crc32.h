@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+#include "../perfect_hash.h"
+
+static constexpr PerfectHashEntry<uint32_t> stock_crc32s[] = {
+    { "beavercreek", 0x07B3876A },
+    { "sidewinder", 0xBD95CF55 },
+    { "damnation", 0x0FBA059D },
+    { "ratrace", 0xF7F8E14C },
+    { "prisoner", 0x43B81A8B },
+    { "hangemhigh", 0xA7C8B9C6 },
+    { "chillout", 0x93C53C27 },
+    { "carousel", 0x9C301A08 },
+    { "boardingaction", 0xF4DEEF94 },
+    { "bloodgulch", 0x7B309554 },
+    { "wizard", 0xCF3359B1 },
+    { "putput", 0xAF2F0B84 },
+    { "longest", 0xC8F48FF6 },
+    { "dangercanyon", 0xC410CD74 },
+    { "deathisland", 0x1DF8C97F },
+    { "gephyrophobia", 0xD2872165 },
+    { "infinity", 0x0E7F7FE7 },
+    { "timberland", 0x54446470 },
+    { "icefields", 0x5EC1DEB7 }
+};
+
+static constexpr auto stock_crc32_map = make_perfect_hash_map(stock_crc32s, static_cast<uint32_t>(0xFFFFFFFF));
+static_assert(stock_crc32_map.valid(), "stock map names must be unique");
+
+/// Get the CRC32 of a stock map by its file name (without the extension), or 0xFFFFFFFF if it isn't one.
+inline uint32_t stock_crc32(const char *name) noexcept {
+    return stock_crc32_map.find(name);
+}
@@ -8,33 +8,31 @@
 #include "../messaging/messaging.h"
 
 static void fix_hud() noexcept {
-    try {
-        HaloTag &tag = HaloTag::lookup("unit_hud_interface", "ui\\hud\\cyborg_mp");
-        auto &unhi = *reinterpret_cast<UnitHUDInterface *>(tag.data);
-        assert_or_bail(unhi.anchor == ANCHOR_TOP_RIGHT);
-        assert_or_bail(unhi.auxiliary_overlays.anchor == ANCHOR_TOP_LEFT);
-        assert_or_bail(unhi.unit_hud_background.position.anchor_offset.x == 0);
-        assert_or_bail(unhi.unit_hud_background.position.anchor_offset.y == 0);
-        assert_or_bail(unhi.shield_panel_background.position.anchor_offset.x == -7);
-        assert_or_bail(unhi.shield_panel_background.position.anchor_offset.y == 1);
-        assert_or_bail(unhi.shield_panel_meter.position.anchor_offset.x == 0);
-        assert_or_bail(unhi.shield_panel_meter.position.anchor_offset.y == 0);
-        assert_or_bail(unhi.health_panel_background.position.anchor_offset.x == 28);
-        assert_or_bail(unhi.health_panel_background.position.anchor_offset.y == -3);
-        assert_or_bail(unhi.health_panel_meter.position.anchor_offset.x == 29);
-        assert_or_bail(unhi.health_panel_meter.position.anchor_offset.y == 11);
-
-        unhi.shield_panel_background.position.scaling_flags.use_high_resolution_scale = 0;
-        unhi.shield_panel_meter.position.scaling_flags.use_high_resolution_scale = 0;
-        unhi.health_panel_background.position.scaling_flags.use_high_resolution_scale = 0;
-        unhi.health_panel_meter.position.scaling_flags.use_high_resolution_scale = 0;
-
-        for(size_t i=0;i<unhi.auxiliary_hud_meters_count;i++) {
-            unhi.auxiliary_hud_meters[i].background.position.scaling_flags.use_high_resolution_scale = 0;
-            unhi.auxiliary_hud_meters[i].meter.position.scaling_flags.use_high_resolution_scale = 0;
-        }
+    auto *tag = HaloTag::lookup("unit_hud_interface", "ui\\hud\\cyborg_mp");
+    if(!tag) return;
+    auto &unhi = *reinterpret_cast<UnitHUDInterface *>(tag->data);
+    assert_or_bail(unhi.anchor == ANCHOR_TOP_RIGHT);
+    assert_or_bail(unhi.auxiliary_overlays.anchor == ANCHOR_TOP_LEFT);
+    assert_or_bail(unhi.unit_hud_background.position.anchor_offset.x == 0);
+    assert_or_bail(unhi.unit_hud_background.position.anchor_offset.y == 0);
+    assert_or_bail(unhi.shield_panel_background.position.anchor_offset.x == -7);
+    assert_or_bail(unhi.shield_panel_background.position.anchor_offset.y == 1);
+    assert_or_bail(unhi.shield_panel_meter.position.anchor_offset.x == 0);
+    assert_or_bail(unhi.shield_panel_meter.position.anchor_offset.y == 0);
+    assert_or_bail(unhi.health_panel_background.position.anchor_offset.x == 28);
+    assert_or_bail(unhi.health_panel_background.position.anchor_offset.y == -3);
+    assert_or_bail(unhi.health_panel_meter.position.anchor_offset.x == 29);
+    assert_or_bail(unhi.health_panel_meter.position.anchor_offset.y == 11);
+
+    unhi.shield_panel_background.position.scaling_flags.use_high_resolution_scale = 0;
+    unhi.shield_panel_meter.position.scaling_flags.use_high_resolution_scale = 0;
+    unhi.health_panel_background.position.scaling_flags.use_high_resolution_scale = 0;
+    unhi.health_panel_meter.position.scaling_flags.use_high_resolution_scale = 0;
+
+    for(size_t i=0;i<unhi.auxiliary_hud_meters_count;i++) {
+        unhi.auxiliary_hud_meters[i].background.position.scaling_flags.use_high_resolution_scale = 0;
+        unhi.auxiliary_hud_meters[i].meter.position.scaling_flags.use_high_resolution_scale = 0;
     }
-    catch(...) {}
 }
 
 ChimeraCommandError split_screen_hud_command(size_t argc, const char **argv) noexcept {
@@ -0,0 +1,73 @@
+// Parse every map given on the command line and report how long it takes.
+//
+// Usage: map_benchmark [-n iterations] <map> [map ...]
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "map_view.h"
+
+struct MapStats {
+    uint32_t tags = 0;
+    uint32_t bsps = 0;
+    uint32_t resources = 0;
+    uint32_t external_resources = 0;
+    uint64_t resource_bytes = 0;
+};
+
+static bool count_resource(const MapResource &resource, void *user) {
+    auto &stats = *reinterpret_cast<MapStats *>(user);
+    stats.resources++;
+    stats.external_resources += resource.external;
+    stats.resource_bytes += resource.size;
+    return true;
+}
+
+static bool parse_map(const char *path, MapStats &stats) noexcept {
+    MapView map(path);
+    if(!map.is_valid()) return false;
+    auto tag_data = map.tag_data();
+    stats.tags = tag_data.tag_count();
+    tag_data.structure_bsps(stats.bsps);
+    tag_data.for_each_resource(count_resource, &stats);
+    return true;
+}
+
+int main(int argc, const char **argv) {
+    int iterations = 100;
+    int first_map = 1;
+    if(argc > 2 && strcmp(argv[1], "-n") == 0) {
+        iterations = atoi(argv[2]);
+        first_map = 3;
+    }
+    if(first_map >= argc || iterations <= 0) {
+        fprintf(stderr, "Usage: %s [-n iterations] <map> [map ...]\n", argv[0]);
+        return 1;
+    }
+
+    double total_time = 0;
+    int parsed = 0;
+    for(int m=first_map;m<argc;m++) {
+        MapStats stats;
+        if(!parse_map(argv[m], stats)) {
+            fprintf(stderr, "%s: not a valid map\n", argv[m]);
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for(int i=0;i<iterations;i++) {
+            MapStats repeat;
+            parse_map(argv[m], repeat);
+        }
+        double time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+        total_time += time;
+        parsed++;
+
+        printf("%s: %u tags, %u BSPs, %u resources (%u external, %llu bytes) - %.1f us\n", argv[m], stats.tags, stats.bsps, stats.resources, stats.external_resources, static_cast<unsigned long long>(stats.resource_bytes), time);
+    }
+
+    if(parsed == 0) return 1;
+    printf("%d maps, %.1f us per map on average\n", parsed, total_time / parsed);
+    return 0;
+}
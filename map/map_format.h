@@ -0,0 +1,130 @@
+#pragma once
+
+#include <stdint.h>
+
+// On-disk structures of Halo PC/CE cache files (.map). Everything here is the same size on every platform, so it can be
+// read straight out of a file or out of Halo's memory.
+
+/// Tag data is always loaded here, and pointers in tag data are relative to it.
+#define MAP_TAG_DATA_ADDRESS 0x40440000
+
+#define MAP_ENGINE_RETAIL 7
+#define MAP_ENGINE_CUSTOM_EDITION 0x261
+
+enum MapGameType : uint16_t {
+    MAP_SINGLE_PLAYER = 0,
+    MAP_MULTIPLAYER,
+    MAP_USER_INTERFACE
+};
+
+struct MapHeader {
+    /// Must be equal to 0x68656164
+    uint32_t head = 0x68656164;
+    /// 7 if retail; 0x261 if Custom Edition; 5 if Xbox
+    uint32_t engine_type;
+    /// Halo ignores map files that are >384 MiB
+    uint32_t file_size;
+    char padding1[4];
+    /// File offset to tag data (which is loaded at 0x40440000)
+    uint32_t tag_data_offset;
+    /// File size of tag data.
+    uint32_t tag_data_size;
+    char padding2[8];
+    /// File name of map excluding extension; typically matches scenario tag name, but not required
+    char name[32];
+    /// Unused on PC version of Halo
+    char build[32];
+    MapGameType game_type;
+    char padding3[2];
+    /// Calculated with CRC32 of BSPs, models, and tag data
+    uint32_t crc32_unused;
+    char padding4[0x794];
+    /// Must be equal to 0x666F6F74
+    uint32_t foot = 0x666F6F74;
+};
+static_assert(sizeof(MapHeader) == 0x800, "MapHeader must be 0x800 bytes");
+
+/// The start of tag data
+struct MapTagDataHeader {
+    /// Address of the tag array
+    uint32_t tag_array;
+    /// Tag ID of the scenario tag
+    uint32_t scenario_tag_id;
+    uint32_t random_number;
+    uint32_t tag_count;
+    uint32_t model_part_count;
+    /// File offset to model data (vertices followed by indices)
+    uint32_t model_data_offset;
+    uint32_t model_part_count_again;
+    /// Offset from model_data_offset to indices
+    uint32_t model_index_offset;
+    /// File size of model data
+    uint32_t model_data_size;
+    /// Must be equal to 0x74616773
+    uint32_t tags;
+};
+
+/// An entry in the tag array. Unlike HaloTag, addresses are stored as integers, since pointers aren't 32-bit everywhere.
+struct MapTag {
+    uint32_t tag_class;
+    uint32_t tag_class_secondary;
+    uint32_t tag_class_tertiary;
+    uint32_t tag_id;
+    /// Address of the tag path
+    uint32_t path;
+    /// Address of the tag's data
+    uint32_t data;
+    uint32_t indexed;
+    char padding[4];
+};
+static_assert(sizeof(MapTag) == 0x20, "MapTag must be 0x20 bytes");
+
+/// A count and address of an array of structures in tag data
+struct MapReflexive {
+    uint32_t count;
+    uint32_t address;
+    char padding[4];
+};
+
+/// A reference from one tag to another
+struct MapTagDependency {
+    uint32_t tag_class;
+    /// Address of the referenced tag's path
+    uint32_t path;
+    uint32_t unknown;
+    /// Tag ID of the referenced tag, or 0xFFFFFFFF if there isn't one
+    uint32_t tag_id;
+};
+static_assert(sizeof(MapTagDependency) == 0x10, "MapTagDependency must be 0x10 bytes");
+
+/// An entry in the scenario's structure BSPs
+struct MapStructureBSP {
+    /// File offset to the BSP
+    uint32_t file_offset;
+    /// File size of the BSP
+    uint32_t size;
+    /// Address the BSP is loaded at
+    uint32_t address;
+    char padding[4];
+    char structure_bsp_dependency[0x10];
+};
+static_assert(sizeof(MapStructureBSP) == 0x20, "MapStructureBSP must be 0x20 bytes");
+
+/// Offset of the structure BSPs reflexive in scenario tag data
+#define MAP_SCENARIO_STRUCTURE_BSPS 0x5A4
+
+/// Offset of the bitmap data reflexive in bitmap tag data, and the size of each bitmap data entry
+#define MAP_BITMAP_DATA 0x60
+#define MAP_BITMAP_DATA_SIZE 0x30
+
+/// Offset of the pitch ranges reflexive in sound tag data, and the size of each pitch range
+#define MAP_SOUND_PITCH_RANGES 0x98
+#define MAP_SOUND_PITCH_RANGE_SIZE 0x48
+
+/// Offset of the permutations reflexive in a pitch range, and the size of each permutation
+#define MAP_SOUND_PERMUTATIONS 0x3C
+#define MAP_SOUND_PERMUTATION_SIZE 0x7C
+
+#define MAP_TAG_CLASS_BITMAP 0x6269746D
+#define MAP_TAG_CLASS_SOUND 0x736E6421
+#define MAP_TAG_CLASS_SCENARIO 0x73636E72
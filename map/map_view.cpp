@@ -0,0 +1,76 @@
+#include "map_view.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MapView::MapView(const char *path) noexcept {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE) return;
+    LARGE_INTEGER size;
+    if(GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(mapping) {
+            this->file_data = reinterpret_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if(this->file_data) this->file_size = size.QuadPart;
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int file = open(path, O_RDONLY);
+    if(file == -1) return;
+    struct stat s;
+    if(fstat(file, &s) == 0 && s.st_size > 0) {
+        void *mapping = mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, file, 0);
+        if(mapping != MAP_FAILED) {
+            this->file_data = reinterpret_cast<const char *>(mapping);
+            this->file_size = s.st_size;
+        }
+    }
+    close(file);
+#endif
+}
+
+MapView::~MapView() noexcept {
+    if(!this->file_data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(this->file_data);
+#else
+    munmap(const_cast<char *>(this->file_data), this->file_size);
+#endif
+}
+
+bool MapView::is_open() const noexcept {
+    return this->file_data != nullptr;
+}
+
+bool MapView::is_valid() const noexcept {
+    if(this->file_size < sizeof(MapHeader)) return false;
+    auto &header = this->header();
+    return header.head == 0x68656164 && header.foot == 0x666F6F74 && header.tag_data_offset <= this->file_size && header.tag_data_size <= this->file_size - header.tag_data_offset;
+}
+
+const char *MapView::data() const noexcept {
+    return this->file_data;
+}
+
+uint64_t MapView::size() const noexcept {
+    return this->file_size;
+}
+
+const MapHeader &MapView::header() const noexcept {
+    return *reinterpret_cast<const MapHeader *>(this->file_data);
+}
+
+TagDataView MapView::tag_data() const noexcept {
+    if(!this->is_valid()) return TagDataView(nullptr, 0);
+    auto &header = this->header();
+    return TagDataView(this->file_data + header.tag_data_offset, header.tag_data_size);
+}
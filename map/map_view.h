@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "tag_data_view.h"
+
+/// A whole map file mapped into memory, read-only. This is meant for tools and offline processing; Halo itself is a
+/// 32-bit process and shouldn't map entire maps.
+class MapView {
+public:
+    /// Map the file at path. Check is_open() and is_valid() afterwards.
+    MapView(const char *path) noexcept;
+    ~MapView() noexcept;
+
+    MapView(const MapView &) = delete;
+    MapView &operator=(const MapView &) = delete;
+
+    /// Return true if the file was opened and mapped.
+    bool is_open() const noexcept;
+
+    /// Return true if the file has a valid header and its tag data is in bounds.
+    bool is_valid() const noexcept;
+
+    /// Get the contents of the file.
+    const char *data() const noexcept;
+
+    /// Get the size of the file in bytes.
+    uint64_t size() const noexcept;
+
+    /// Get the header. Only call this if is_valid() returns true.
+    const MapHeader &header() const noexcept;
+
+    /// Get the map's tag data. If the map isn't valid, the view is empty.
+    TagDataView tag_data() const noexcept;
+
+private:
+    const char *file_data = nullptr;
+    uint64_t file_size = 0;
+};
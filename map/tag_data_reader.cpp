@@ -0,0 +1,89 @@
+#include "tag_data_reader.h"
+
+TagDataReader::TagDataReader(const MapHeader &header, read_fn read, void *user) noexcept : offset(header.tag_data_offset), size(header.tag_data_size), read_file(read), user(user) {}
+
+bool TagDataReader::read_bytes(uint32_t address, void *output, size_t size) const noexcept {
+    if(address < MAP_TAG_DATA_ADDRESS || size > this->size || address - MAP_TAG_DATA_ADDRESS > this->size - size) return false;
+    return this->read_file(this->offset + (address - MAP_TAG_DATA_ADDRESS), output, size, this->user);
+}
+
+bool TagDataReader::header(MapTagDataHeader &header) const noexcept {
+    return this->read(MAP_TAG_DATA_ADDRESS, &header);
+}
+
+bool TagDataReader::tags(std::vector<MapTag> &tags) const noexcept {
+    MapTagDataHeader header;
+    if(!this->header(header)) return false;
+    MapReflexive reflexive = {};
+    reflexive.count = header.tag_count;
+    reflexive.address = header.tag_array;
+    return this->read(reflexive, tags);
+}
+
+bool TagDataReader::structure_bsps(std::vector<MapStructureBSP> &structure_bsps) const noexcept {
+    MapTagDataHeader header;
+    MapTag scenario;
+    MapReflexive reflexive;
+    if(!this->header(header) ||
+       !this->read(header.tag_array + (header.scenario_tag_id & 0xFFFF) * sizeof(MapTag), &scenario) ||
+       !this->read(scenario.data + MAP_SCENARIO_STRUCTURE_BSPS, &reflexive)) {
+        return false;
+    }
+    return this->read(reflexive, structure_bsps);
+}
+
+bool TagDataReader::for_each_resource(TagDataView::resource_fn callback, void *user) const noexcept {
+    std::vector<MapTag> tags;
+    if(!this->tags(tags)) return false;
+
+    // Reused for each tag's arrays so they're only as big as the largest one.
+    std::vector<char> buffer;
+    for(uint32_t t=0;t<tags.size();t++) {
+        if(tags[t].tag_class == MAP_TAG_CLASS_BITMAP) {
+            if(!this->for_each_bitmap_resource(t, tags[t], callback, user, buffer)) return false;
+        }
+        else if(tags[t].tag_class == MAP_TAG_CLASS_SOUND) {
+            if(!this->for_each_sound_resource(t, tags[t], callback, user, buffer)) return false;
+        }
+    }
+    return true;
+}
+
+bool TagDataReader::read_array(uint32_t address, uint32_t count, size_t element_size, std::vector<char> &buffer) const noexcept {
+    uint64_t size = static_cast<uint64_t>(count) * element_size;
+    if(size > this->size) return false;
+    if(buffer.size() < size) buffer.resize(static_cast<size_t>(size));
+    return this->read_bytes(address, buffer.data(), static_cast<size_t>(size));
+}
+
+bool TagDataReader::for_each_bitmap_resource(uint32_t tag_index, const MapTag &tag, TagDataView::resource_fn callback, void *user, std::vector<char> &buffer) const noexcept {
+    MapReflexive reflexive;
+    if(!this->read(tag.data + MAP_BITMAP_DATA, &reflexive) || !this->read_array(reflexive.address, reflexive.count, MAP_BITMAP_DATA_SIZE, buffer)) return true;
+
+    for(uint32_t b=0;b<reflexive.count;b++) {
+        auto resource = map_bitmap_resource(tag_index, buffer.data() + b * MAP_BITMAP_DATA_SIZE, reflexive.address + b * MAP_BITMAP_DATA_SIZE);
+        if(!callback(resource, user)) return false;
+    }
+    return true;
+}
+
+bool TagDataReader::for_each_sound_resource(uint32_t tag_index, const MapTag &tag, TagDataView::resource_fn callback, void *user, std::vector<char> &buffer) const noexcept {
+    MapReflexive ranges_reflexive;
+    if(!this->read(tag.data + MAP_SOUND_PITCH_RANGES, &ranges_reflexive) || !this->read_array(ranges_reflexive.address, ranges_reflexive.count, MAP_SOUND_PITCH_RANGE_SIZE, buffer)) return true;
+
+    // Only the permutation reflexives are needed, and the buffer is about to be reused for the permutations.
+    std::vector<MapReflexive> reflexives(ranges_reflexive.count);
+    for(uint32_t r=0;r<ranges_reflexive.count;r++) {
+        reflexives[r] = *reinterpret_cast<const MapReflexive *>(buffer.data() + r * MAP_SOUND_PITCH_RANGE_SIZE + MAP_SOUND_PERMUTATIONS);
+    }
+
+    for(auto &reflexive : reflexives) {
+        if(!this->read_array(reflexive.address, reflexive.count, MAP_SOUND_PERMUTATION_SIZE, buffer)) continue;
+
+        for(uint32_t p=0;p<reflexive.count;p++) {
+            auto resource = map_sound_resource(tag_index, buffer.data() + p * MAP_SOUND_PERMUTATION_SIZE, reflexive.address + p * MAP_SOUND_PERMUTATION_SIZE);
+            if(!callback(resource, user)) return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+#include "tag_data_view.h"
+
+/// Bounds-checked access to the tag data of a map file that reads only the fields it needs, for when the tag data isn't
+/// in memory and loading all of it would cost more than it's worth. Use TagDataView when the tag data is in memory.
+class TagDataReader {
+public:
+    /// Copy size bytes at file offset into output. Return false if they can't be read.
+    typedef bool (*read_fn)(uint64_t offset, void *output, size_t size, void *user);
+
+    /// Read tag data from a map file with the given header. Everything is read through read.
+    TagDataReader(const MapHeader &header, read_fn read, void *user) noexcept;
+
+    /// Copy count Ts at address into output. Return false if any of it is out of bounds or can't be read.
+    template<typename T> bool read(uint32_t address, T *output, size_t count = 1) const noexcept {
+        return this->read_bytes(address, output, sizeof(T) * count);
+    }
+
+    /// Copy the array referenced by a reflexive into output. Return false if any of it is out of bounds or can't be read.
+    template<typename T> bool read(const MapReflexive &reflexive, std::vector<T> &output) const noexcept {
+        if(static_cast<uint64_t>(reflexive.count) * sizeof(T) > this->size) return false;
+        output.resize(reflexive.count);
+        return this->read(reflexive.address, output.data(), output.size());
+    }
+
+    /// Copy size bytes at address into output. Return false if any of it is out of bounds or can't be read.
+    bool read_bytes(uint32_t address, void *output, size_t size) const noexcept;
+
+    /// Read the tag data header. Return false if it can't be read.
+    bool header(MapTagDataHeader &header) const noexcept;
+
+    /// Read the tag array. Return false if it can't be read.
+    bool tags(std::vector<MapTag> &tags) const noexcept;
+
+    /// Read the scenario's structure BSPs. Return false if the scenario tag or its BSPs can't be read.
+    bool structure_bsps(std::vector<MapStructureBSP> &structure_bsps) const noexcept;
+
+    /// Call callback for every bitmap and sound resource in the map, in tag order, like
+    /// TagDataView::for_each_resource(). Tags with out of bounds data are skipped. Return false if the tag array can't
+    /// be read or callback stopped early.
+    bool for_each_resource(TagDataView::resource_fn callback, void *user) const noexcept;
+
+private:
+    uint64_t offset;
+    uint32_t size;
+    read_fn read_file;
+    void *user;
+
+    /// Read an array of count elements of element_size bytes at address into buffer, growing it if needed.
+    bool read_array(uint32_t address, uint32_t count, size_t element_size, std::vector<char> &buffer) const noexcept;
+    bool for_each_bitmap_resource(uint32_t tag_index, const MapTag &tag, TagDataView::resource_fn callback, void *user, std::vector<char> &buffer) const noexcept;
+    bool for_each_sound_resource(uint32_t tag_index, const MapTag &tag, TagDataView::resource_fn callback, void *user, std::vector<char> &buffer) const noexcept;
+};
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <string.h>
+#include <vector>
+#include "tag_data_view.h"
+
+TagDataView::TagDataView(const void *data, size_t size, uint32_t address) noexcept : data(reinterpret_cast<const char *>(data)), size(size), address(address) {}
+
+const char *TagDataView::get_bytes(uint32_t address, size_t size) const noexcept {
+    if(!this->data || address < this->address || size > this->size || address - this->address > this->size - size) return nullptr;
+    return this->data + (address - this->address);
+}
+
+const char *TagDataView::get_string(uint32_t address) const noexcept {
+    auto *string = this->get_bytes(address, 1);
+    if(!string) return nullptr;
+    return memchr(string, 0, this->size - (address - this->address)) ? string : nullptr;
+}
+
+const MapTagDataHeader *TagDataView::header() const noexcept {
+    return this->get<MapTagDataHeader>(this->address);
+}
+
+const MapTag *TagDataView::tags() const noexcept {
+    auto *header = this->header();
+    return header ? this->get<MapTag>(header->tag_array, header->tag_count) : nullptr;
+}
+
+uint32_t TagDataView::tag_count() const noexcept {
+    return this->tags() ? this->header()->tag_count : 0;
+}
+
+const MapTag *TagDataView::scenario_tag() const noexcept {
+    auto *tags = this->tags();
+    if(!tags) return nullptr;
+    uint32_t index = this->header()->scenario_tag_id & 0xFFFF;
+    return index < this->tag_count() ? tags + index : nullptr;
+}
+
+const MapStructureBSP *TagDataView::structure_bsps(uint32_t &count) const noexcept {
+    count = 0;
+    auto *scenario = this->scenario_tag();
+    if(!scenario) return nullptr;
+    auto *reflexive = this->get<MapReflexive>(scenario->data + MAP_SCENARIO_STRUCTURE_BSPS);
+    if(!reflexive) return nullptr;
+    auto *bsps = this->get<MapStructureBSP>(*reflexive);
+    if(bsps) count = reflexive->count;
+    return bsps;
+}
+
+bool TagDataView::for_each_resource(resource_fn callback, void *user) const noexcept {
+    auto *tags = this->tags();
+    auto tag_count = this->tag_count();
+    for(uint32_t t=0;t<tag_count;t++) {
+        if(tags[t].tag_class == MAP_TAG_CLASS_BITMAP) {
+            if(!this->for_each_bitmap_resource(t, tags[t], callback, user)) return false;
+        }
+        else if(tags[t].tag_class == MAP_TAG_CLASS_SOUND) {
+            if(!this->for_each_sound_resource(t, tags[t], callback, user)) return false;
+        }
+    }
+    return true;
+}
+
+bool TagDataView::for_each_dependency(dependency_fn callback, void *user) const noexcept {
+    auto *tags = this->tags();
+    auto tag_count = this->tag_count();
+
+    // Order tags by where their data is, so each one is searched from its own data up to the next tag's.
+    std::vector<uint32_t> order;
+    order.reserve(tag_count);
+    for(uint32_t t=0;t<tag_count;t++) {
+        if(this->get_bytes(tags[t].data, 1)) order.push_back(t);
+    }
+    std::sort(order.begin(), order.end(), [tags](uint32_t a, uint32_t b) {
+        return tags[a].data < tags[b].data;
+    });
+
+    uint32_t data_end = this->address + static_cast<uint32_t>(this->size);
+    for(size_t i=0;i<order.size();i++) {
+        uint32_t start = tags[order[i]].data;
+        uint32_t end = i + 1 < order.size() ? tags[order[i + 1]].data : data_end;
+        if(end - start < sizeof(MapTagDependency)) continue;
+
+        // Tag data is 4-byte aligned, so references are too.
+        auto *words = this->get<uint32_t>(start, (end - start) / 4);
+        size_t word_count = (end - start) / 4;
+        for(size_t w=0;w + 3 < word_count;w++) {
+            auto &dependency = *reinterpret_cast<const MapTagDependency *>(words + w);
+            uint32_t target = dependency.tag_id & 0xFFFF;
+            if(target >= tag_count || tags[target].tag_id != dependency.tag_id || tags[target].path != dependency.path) continue;
+
+            MapDependency found;
+            found.tag_index = order[i];
+            found.target_index = target;
+            found.address = start + static_cast<uint32_t>(w * 4);
+            if(!callback(found, user)) return false;
+            w += 3;
+        }
+    }
+    return true;
+}
+
+bool TagDataView::for_each_bitmap_resource(uint32_t tag_index, const MapTag &tag, resource_fn callback, void *user) const noexcept {
+    auto *reflexive = this->get<MapReflexive>(tag.data + MAP_BITMAP_DATA);
+    if(!reflexive) return true;
+    auto *bitmaps = this->get_bytes(reflexive->address, static_cast<size_t>(reflexive->count) * MAP_BITMAP_DATA_SIZE);
+    if(!bitmaps) return true;
+
+    for(uint32_t b=0;b<reflexive->count;b++) {
+        auto resource = map_bitmap_resource(tag_index, bitmaps + b * MAP_BITMAP_DATA_SIZE, reflexive->address + b * MAP_BITMAP_DATA_SIZE);
+        if(!callback(resource, user)) return false;
+    }
+    return true;
+}
+
+bool TagDataView::for_each_sound_resource(uint32_t tag_index, const MapTag &tag, resource_fn callback, void *user) const noexcept {
+    auto *ranges_reflexive = this->get<MapReflexive>(tag.data + MAP_SOUND_PITCH_RANGES);
+    if(!ranges_reflexive) return true;
+    auto *ranges = this->get_bytes(ranges_reflexive->address, static_cast<size_t>(ranges_reflexive->count) * MAP_SOUND_PITCH_RANGE_SIZE);
+    if(!ranges) return true;
+
+    for(uint32_t r=0;r<ranges_reflexive->count;r++) {
+        auto *reflexive = reinterpret_cast<const MapReflexive *>(ranges + r * MAP_SOUND_PITCH_RANGE_SIZE + MAP_SOUND_PERMUTATIONS);
+        auto *permutations = this->get_bytes(reflexive->address, static_cast<size_t>(reflexive->count) * MAP_SOUND_PERMUTATION_SIZE);
+        if(!permutations) continue;
+
+        for(uint32_t p=0;p<reflexive->count;p++) {
+            auto resource = map_sound_resource(tag_index, permutations + p * MAP_SOUND_PERMUTATION_SIZE, reflexive->address + p * MAP_SOUND_PERMUTATION_SIZE);
+            if(!callback(resource, user)) return false;
+        }
+    }
+    return true;
+}
+
+MapResource map_bitmap_resource(uint32_t tag_index, const char *bitmap, uint32_t address) noexcept {
+    MapResource resource;
+    resource.type = MAP_RESOURCE_BITMAP;
+    resource.tag_index = tag_index;
+    resource.external = bitmap[0xF] & 1;
+    resource.offset = *reinterpret_cast<const uint32_t *>(bitmap + 0x18);
+    resource.size = *reinterpret_cast<const uint32_t *>(bitmap + 0x1C);
+    resource.offset_address = address + 0x18;
+    return resource;
+}
+
+MapResource map_sound_resource(uint32_t tag_index, const char *permutation, uint32_t address) noexcept {
+    MapResource resource;
+    resource.type = MAP_RESOURCE_SOUND;
+    resource.tag_index = tag_index;
+    resource.external = permutation[0x44] & 1;
+    resource.size = *reinterpret_cast<const uint32_t *>(permutation + 0x40);
+    resource.offset = *reinterpret_cast<const uint32_t *>(permutation + 0x48);
+    resource.offset_address = address + 0x48;
+    return resource;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stddef.h>
+#include "map_format.h"
+
+enum MapResourceType {
+    MAP_RESOURCE_BITMAP,
+    MAP_RESOURCE_SOUND
+};
+
+/// Bitmap or sound data referenced by a tag
+struct MapResource {
+    MapResourceType type;
+    /// Index of the tag in the tag array
+    uint32_t tag_index;
+    /// If true, the data is in bitmaps.map or sounds.map rather than in the map itself.
+    bool external;
+    /// File offset of the data
+    uint32_t offset;
+    /// Size of the data in bytes
+    uint32_t size;
+    /// Address of the offset field, so it can be patched where tag data is writable
+    uint32_t offset_address;
+};
+
+/// Get the resource described by a bitmap data entry (MAP_BITMAP_DATA_SIZE bytes) whose address is address.
+MapResource map_bitmap_resource(uint32_t tag_index, const char *bitmap, uint32_t address) noexcept;
+
+/// Get the resource described by a sound permutation (MAP_SOUND_PERMUTATION_SIZE bytes) whose address is address.
+MapResource map_sound_resource(uint32_t tag_index, const char *permutation, uint32_t address) noexcept;
+
+/// A reference from one tag to another, found in tag data
+struct MapDependency {
+    /// Index of the tag the reference is in
+    uint32_t tag_index;
+    /// Index of the tag being referenced
+    uint32_t target_index;
+    /// Address of the reference
+    uint32_t address;
+};
+
+/// Bounds-checked, read-only access to tag data, wherever it is. This can be a mapped map file, a copy of the tag data
+/// read from one, or tag data loaded by Halo. Nothing is copied out of it.
+class TagDataView {
+public:
+    /// Wrap size bytes of tag data at data, which is addressed as if it were at address.
+    TagDataView(const void *data, size_t size, uint32_t address = MAP_TAG_DATA_ADDRESS) noexcept;
+
+    /// Get count Ts at address, or nullptr if any of it is out of bounds.
+    template<typename T> const T *get(uint32_t address, size_t count = 1) const noexcept {
+        return reinterpret_cast<const T *>(this->get_bytes(address, sizeof(T) * count));
+    }
+
+    /// Get the array referenced by a reflexive, or nullptr if any of it is out of bounds.
+    template<typename T> const T *get(const MapReflexive &reflexive) const noexcept {
+        return this->get<T>(reflexive.address, reflexive.count);
+    }
+
+    /// Get size bytes at address, or nullptr if any of it is out of bounds.
+    const char *get_bytes(uint32_t address, size_t size) const noexcept;
+
+    /// Get a null-terminated string at address, or nullptr if it isn't terminated before the end of tag data.
+    const char *get_string(uint32_t address) const noexcept;
+
+    /// Get the tag data header, or nullptr if the tag data is too small.
+    const MapTagDataHeader *header() const noexcept;
+
+    /// Get the tag array, or nullptr if it's out of bounds. The number of tags is tag_count().
+    const MapTag *tags() const noexcept;
+
+    /// Get the number of tags in the tag array, or 0 if it's out of bounds.
+    uint32_t tag_count() const noexcept;
+
+    /// Get the scenario tag, or nullptr if it's missing or out of bounds.
+    const MapTag *scenario_tag() const noexcept;
+
+    /// Get the scenario's structure BSPs, or nullptr if they're out of bounds. The number of BSPs is written to count.
+    const MapStructureBSP *structure_bsps(uint32_t &count) const noexcept;
+
+    /// Callback for for_each_resource(). Return false to stop.
+    typedef bool (*resource_fn)(const MapResource &resource, void *user);
+
+    /// Call callback for every bitmap and sound resource in the map, in tag order. Tags with out of bounds data are
+    /// skipped. Return false if callback stopped early.
+    bool for_each_resource(resource_fn callback, void *user) const noexcept;
+
+    /// Callback for for_each_dependency(). Return false to stop.
+    typedef bool (*dependency_fn)(const MapDependency &dependency, void *user);
+
+    /// Call callback for every tag dependency in the map, in address order. Tag definitions aren't known here, so this
+    /// looks for anything shaped like a dependency: a tag ID of an existing tag, preceded by a pointer to that tag's
+    /// path. A reference belongs to the tag whose data starts closest before it. Tags with out of bounds data (such as
+    /// BSPs loaded elsewhere) aren't searched. Return false if callback stopped early.
+    bool for_each_dependency(dependency_fn callback, void *user) const noexcept;
+
+private:
+    const char *data;
+    size_t size;
+    uint32_t address;
+
+    bool for_each_bitmap_resource(uint32_t tag_index, const MapTag &tag, resource_fn callback, void *user) const noexcept;
+    bool for_each_sound_resource(uint32_t tag_index, const MapTag &tag, resource_fn callback, void *user) const noexcept;
+};
@@ -0,0 +1,246 @@
+#include <cmath>
+#include "batch.h"
+#include "batch_impl.h"
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#define BATCH_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+#endif
+
+static void scalar_lerp(const float *before, size_t before_stride, const float *after, size_t after_stride, float *output, size_t output_stride, size_t count, size_t components, float scale, bool predict) {
+	for(size_t i = 0; i < count; i++) {
+		auto *b = before + i * before_stride;
+		auto *a = after + i * after_stride;
+		auto *o = output + i * output_stride;
+		auto *base = predict ? a : b;
+		for(size_t c = 0; c < components; c++) {
+			o[c] = base[c] + (a[c] - b[c]) * scale;
+		}
+	}
+}
+
+static void scalar_nlerp(const float *const before[3], const float *const after[3], const float *radius, float *const output[3], size_t count, float scale) {
+	for(size_t i = 0; i < count; i++) {
+		float x = before[0][i] + (after[0][i] - before[0][i]) * scale;
+		float y = before[1][i] + (after[1][i] - before[1][i]) * scale;
+		float z = before[2][i] + (after[2][i] - before[2][i]) * scale;
+		float length = sqrt(x * x + y * y + z * z);
+		float factor = length > 0 ? radius[i] / length : 1.0f;
+		output[0][i] = x * factor;
+		output[1][i] = y * factor;
+		output[2][i] = z * factor;
+	}
+}
+
+static void scalar_slerp(const float *before, size_t before_stride, const float *after, size_t after_stride, float *output, size_t output_stride, size_t count, float scale) {
+	for(size_t i = 0; i < count; i++) {
+		auto *b = before + i * before_stride;
+		auto *a = after + i * after_stride;
+		auto *o = output + i * output_stride;
+
+		float sign = 1.0f;
+		float cos_half_theta = b[0] * a[0] + b[1] * a[1] + b[2] * a[2] + b[3] * a[3];
+		if(cos_half_theta < 0) {
+			sign = -1.0f;
+			cos_half_theta *= -1;
+		}
+		if(cos_half_theta < 0.01f) continue;
+		if(cos_half_theta > 1.0f) cos_half_theta = 1.0f;
+
+		float r0 = 1 - scale;
+		float r1 = scale;
+		float sin_half_theta = sqrt(1 - cos_half_theta * cos_half_theta);
+		if(sin_half_theta > 0.00001f) {
+			float half_theta = acos(cos_half_theta);
+			r0 = sin((1 - scale) * half_theta) / sin_half_theta;
+			r1 = sin(scale * half_theta) / sin_half_theta;
+		}
+		r1 *= sign;
+
+		for(size_t c = 0; c < 4; c++) {
+			o[c] = a[c] * r1 + b[c] * r0;
+		}
+	}
+}
+
+static void scalar_normalize(float *vectors, size_t stride, size_t count, size_t components) {
+	for(size_t i = 0; i < count; i++) {
+		auto *v = vectors + i * stride;
+		float length_squared = 0;
+		for(size_t c = 0; c < components; c++) {
+			length_squared += v[c] * v[c];
+		}
+		if(length_squared <= 0) continue;
+		float factor = 1.0f / sqrt(length_squared);
+		for(size_t c = 0; c < components; c++) {
+			v[c] *= factor;
+		}
+	}
+}
+
+static void scalar_distance_squared(const float *point, const float *points, size_t stride, size_t count, float *output) {
+	for(size_t i = 0; i < count; i++) {
+		auto *p = points + i * stride;
+		output[i] = distance_squared(point[0], point[1], point[2], p[0], p[1], p[2]);
+	}
+}
+
+static void scalar_quaternion_to_matrix(const float *quaternions, size_t quaternion_stride, float *matrices, size_t matrix_stride, size_t count) {
+	for(size_t i = 0; i < count; i++) {
+		auto m = RotationMatrix(*reinterpret_cast<const Quaternion *>(quaternions + i * quaternion_stride));
+		auto *o = matrices + i * matrix_stride;
+		for(size_t r = 0; r < 3; r++) {
+			o[r * 3 + 0] = m.v[r].x;
+			o[r * 3 + 1] = m.v[r].y;
+			o[r * 3 + 2] = m.v[r].z;
+		}
+	}
+}
+
+static void scalar_matrix_to_quaternion(const float *matrices, size_t matrix_stride, float *quaternions, size_t quaternion_stride, size_t count) {
+	for(size_t i = 0; i < count; i++) {
+		auto q = Quaternion(*reinterpret_cast<const RotationMatrix *>(matrices + i * matrix_stride));
+		auto *o = quaternions + i * quaternion_stride;
+		o[0] = q.x;
+		o[1] = q.y;
+		o[2] = q.z;
+		o[3] = q.w;
+	}
+}
+
+static void scalar_live_slots(const uint16_t *salts, size_t stride, size_t count, uint32_t *mask) {
+	for(size_t i = 0; i < count; i += 32) {
+		size_t end = count - i < 32 ? count - i : 32;
+		uint32_t word = 0;
+		for(size_t j = 0; j < end; j++) {
+			uint16_t salt = salts[(i + j) * stride];
+			word |= static_cast<uint32_t>(salt != 0 && salt != 0xFFFF) << j;
+		}
+		mask[i / 32] = word;
+	}
+}
+
+const BatchFunctions batch_functions_scalar = {
+	scalar_lerp,
+	scalar_nlerp,
+	scalar_slerp,
+	scalar_normalize,
+	scalar_distance_squared,
+	scalar_quaternion_to_matrix,
+	scalar_matrix_to_quaternion,
+	scalar_live_slots
+};
+
+static BatchInstructionSet best_instruction_set() noexcept {
+#if defined(BATCH_X86) && defined(__GNUC__)
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return BATCH_INSTRUCTION_SET_AVX2;
+	if(__builtin_cpu_supports("sse2")) return BATCH_INSTRUCTION_SET_SSE2;
+#elif defined(BATCH_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	bool sse2 = (info[3] & (1 << 26)) != 0;
+	bool fma = (info[2] & (1 << 12)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+	if(fma && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+		__cpuidex(info, 7, 0);
+		if(info[1] & (1 << 5)) return BATCH_INSTRUCTION_SET_AVX2;
+	}
+	if(sse2) return BATCH_INSTRUCTION_SET_SSE2;
+#endif
+	return BATCH_INSTRUCTION_SET_SCALAR;
+}
+
+static const BatchFunctions &functions_for(BatchInstructionSet instruction_set) noexcept {
+	switch(instruction_set) {
+#ifdef BATCH_X86
+		case BATCH_INSTRUCTION_SET_AVX2:
+			return batch_functions_avx2;
+		case BATCH_INSTRUCTION_SET_SSE2:
+			return batch_functions_sse2;
+#endif
+		default:
+			return batch_functions_scalar;
+	}
+}
+
+static BatchInstructionSet current_instruction_set = best_instruction_set();
+static const BatchFunctions *functions = &functions_for(current_instruction_set);
+
+BatchInstructionSet batch_instruction_set() noexcept {
+	return current_instruction_set;
+}
+
+BatchInstructionSet batch_set_instruction_set(BatchInstructionSet instruction_set) noexcept {
+	auto best = best_instruction_set();
+	current_instruction_set = instruction_set > best ? best : instruction_set;
+	functions = &functions_for(current_instruction_set);
+	return current_instruction_set;
+}
+
+// Strides handed to the implementations are in floats.
+#define float_stride(span) ((span).stride / sizeof(float))
+
+void batch_lerp(Span<const float> before, Span<const float> after, Span<float> output, float scale) noexcept {
+	functions->lerp(before.data, float_stride(before), after.data, float_stride(after), output.data, float_stride(output), output.count, 1, scale, false);
+}
+
+void batch_lerp(Span<const Vector3D> before, Span<const Vector3D> after, Span<Vector3D> output, float scale) noexcept {
+	functions->lerp(&before.data->x, float_stride(before), &after.data->x, float_stride(after), &output.data->x, float_stride(output), output.count, 3, scale, false);
+}
+
+void batch_lerp_predict(Span<const float> before, Span<const float> after, Span<float> output, float scale) noexcept {
+	functions->lerp(before.data, float_stride(before), after.data, float_stride(after), output.data, float_stride(output), output.count, 1, scale, true);
+}
+
+void batch_lerp_predict(Span<const Vector3D> before, Span<const Vector3D> after, Span<Vector3D> output, float scale) noexcept {
+	functions->lerp(&before.data->x, float_stride(before), &after.data->x, float_stride(after), &output.data->x, float_stride(output), output.count, 3, scale, true);
+}
+
+void batch_nlerp(const Vector3DSoA &before, const Vector3DSoA &after, Span<const float> radius, const Vector3DSoA &output, float scale) noexcept {
+	const float *const b[3] = { before.x, before.y, before.z };
+	const float *const a[3] = { after.x, after.y, after.z };
+	float *const o[3] = { output.x, output.y, output.z };
+	functions->nlerp(b, a, radius.data, o, radius.count, scale);
+}
+
+void batch_slerp(Span<const Quaternion> before, Span<const Quaternion> after, Span<Quaternion> output, float scale) noexcept {
+	functions->slerp(&before.data->x, float_stride(before), &after.data->x, float_stride(after), &output.data->x, float_stride(output), output.count, scale);
+}
+
+void batch_normalize(Span<Vector3D> vectors) noexcept {
+	functions->normalize(&vectors.data->x, float_stride(vectors), vectors.count, 3);
+}
+
+void batch_normalize(Span<Quaternion> quaternions) noexcept {
+	functions->normalize(&quaternions.data->x, float_stride(quaternions), quaternions.count, 4);
+}
+
+void batch_distance_squared(const Vector3D &point, Span<const Vector3D> points, Span<float> output) noexcept {
+	const float p[3] = { point.x, point.y, point.z };
+	if(output.stride == sizeof(float)) {
+		functions->distance_squared(p, &points.data->x, float_stride(points), output.count, output.data);
+	}
+	else {
+		for(size_t i = 0; i < output.count; i++) {
+			auto *point_i = reinterpret_cast<const Vector3D *>(reinterpret_cast<const char *>(points.data) + i * points.stride);
+			*reinterpret_cast<float *>(reinterpret_cast<char *>(output.data) + i * output.stride) = distance_squared(point, *point_i);
+		}
+	}
+}
+
+void batch_quaternion_to_matrix(Span<const Quaternion> quaternions, Span<RotationMatrix> output) noexcept {
+	functions->quaternion_to_matrix(&quaternions.data->x, float_stride(quaternions), &output.data->v[0].x, float_stride(output), output.count);
+}
+
+void batch_matrix_to_quaternion(Span<const RotationMatrix> matrices, Span<Quaternion> output) noexcept {
+	functions->matrix_to_quaternion(&matrices.data->v[0].x, float_stride(matrices), &output.data->x, float_stride(output), output.count);
+}
+
+void batch_live_slots(Span<const uint16_t> salts, uint32_t *mask) noexcept {
+	functions->live_slots(salts.data, salts.stride / sizeof(uint16_t), salts.count, mask);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "data_types.h"
+
+/// This is a non-owning view of count elements, similar to C++20's std::span.
+///
+/// stride is the distance in bytes between elements. This lets a span walk one member of an array of larger structs
+/// in place, such as the rotation of every node in a model.
+template <typename T>
+struct Span {
+    T *data;
+    size_t count;
+    size_t stride;
+
+    Span(T *data, size_t count, size_t stride = sizeof(T)) noexcept : data(data), count(count), stride(stride) {}
+
+    template <size_t N>
+    Span(T (&array)[N]) noexcept : data(array), count(N), stride(sizeof(T)) {}
+
+    /// Allow a span of T to be passed where a span of const T is expected.
+    operator Span<const T>() const noexcept {
+        return Span<const T>(this->data, this->count, this->stride);
+    }
+};
+
+enum BatchInstructionSet {
+    /// Plain C++. This is the reference implementation.
+    BATCH_INSTRUCTION_SET_SCALAR = 0,
+
+    /// SSE2; four elements at a time.
+    BATCH_INSTRUCTION_SET_SSE2,
+
+    /// AVX2 and FMA; eight elements at a time.
+    BATCH_INSTRUCTION_SET_AVX2
+};
+
+/// Get the instruction set the batch functions are currently using. By default, this is the best one the CPU supports.
+BatchInstructionSet batch_instruction_set() noexcept;
+
+/// Use a different instruction set. If the CPU does not support it, the best supported one below it is used instead.
+/// Returns the instruction set now in use.
+BatchInstructionSet batch_set_instruction_set(BatchInstructionSet instruction_set) noexcept;
+
+// Unless otherwise noted, each function below processes output.count elements, and each input span must have at least
+// that many elements.
+
+/// Interpolate floats.
+void batch_lerp(Span<const float> before, Span<const float> after, Span<float> output, float scale) noexcept;
+
+/// Interpolate 3D vectors.
+void batch_lerp(Span<const Vector3D> before, Span<const Vector3D> after, Span<Vector3D> output, float scale) noexcept;
+
+/// Interpolate floats, but add the delta to the after values instead. See interpolate_vector_predict.
+void batch_lerp_predict(Span<const float> before, Span<const float> after, Span<float> output, float scale) noexcept;
+
+/// Interpolate 3D vectors, but add the delta to the after vectors instead. See interpolate_vector_predict.
+void batch_lerp_predict(Span<const Vector3D> before, Span<const Vector3D> after, Span<Vector3D> output, float scale) noexcept;
+
+/// Interpolate 3D vectors stored as structure-of-arrays, then scale each result to the given radius. This processes
+/// radius.count vectors.
+void batch_nlerp(const Vector3DSoA &before, const Vector3DSoA &after, Span<const float> radius, const Vector3DSoA &output, float scale) noexcept;
+
+/// Spherically interpolate quaternions. Pairs that are more than ~180 degrees apart are left untouched in the output,
+/// as interpolate_quat does.
+void batch_slerp(Span<const Quaternion> before, Span<const Quaternion> after, Span<Quaternion> output, float scale) noexcept;
+
+/// Normalize 3D vectors in place. Zero-length vectors are left untouched.
+void batch_normalize(Span<Vector3D> vectors) noexcept;
+
+/// Normalize quaternions in place. Zero-length quaternions are left untouched.
+void batch_normalize(Span<Quaternion> quaternions) noexcept;
+
+/// Calculate the squared distance from point to each of points.
+void batch_distance_squared(const Vector3D &point, Span<const Vector3D> points, Span<float> output) noexcept;
+
+/// Convert quaternions to rotation matrices.
+void batch_quaternion_to_matrix(Span<const Quaternion> quaternions, Span<RotationMatrix> output) noexcept;
+
+/// Convert rotation matrices to quaternions.
+void batch_matrix_to_quaternion(Span<const RotationMatrix> matrices, Span<Quaternion> output) noexcept;
+
+/// Find live slots in one of Halo's tables from the salt at the start of each entry. A salt of 0 or 0xFFFF means the
+/// slot is free. Bit i % 32 of mask[i / 32] is set if slot i is live, and mask needs (salts.count + 31) / 32 words.
+/// The stride must be a multiple of 2 bytes. Only packed salts are vectorized.
+void batch_live_slots(Span<const uint16_t> salts, uint32_t *mask) noexcept;
@@ -0,0 +1,66 @@
+// This file is compiled with AVX2 and FMA enabled. Nothing in it may be called unless the CPU supports both (see
+// batch.cpp).
+
+#include "batch_impl.h"
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+
+#include <immintrin.h>
+
+namespace {
+    struct L {
+        typedef __m256 V;
+        static const size_t WIDTH = 8;
+
+        static inline V set1(float f) { return _mm256_set1_ps(f); }
+        static inline V load(const float *p) { return _mm256_loadu_ps(p); }
+        static inline void store(float *p, V v) { _mm256_storeu_ps(p, v); }
+        static inline V gather(const float *p, size_t stride) {
+            if(stride == 1) return _mm256_loadu_ps(p);
+            __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(stride)));
+            return _mm256_i32gather_ps(p, index, 4);
+        }
+        static inline void scatter(float *p, size_t stride, V v) {
+            if(stride == 1) return _mm256_storeu_ps(p, v);
+            alignas(32) float lanes[WIDTH];
+            _mm256_store_ps(lanes, v);
+            for(size_t l = 0; l < WIDTH; l++) {
+                p[l * stride] = lanes[l];
+            }
+        }
+        static inline V add(V a, V b) { return _mm256_add_ps(a, b); }
+        static inline V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+        static inline V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+        static inline V div(V a, V b) { return _mm256_div_ps(a, b); }
+        static inline V sqrt(V a) { return _mm256_sqrt_ps(a); }
+        static inline V min(V a, V b) { return _mm256_min_ps(a, b); }
+        static inline V max(V a, V b) { return _mm256_max_ps(a, b); }
+        static inline V abs(V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+        static inline V neg(V a) { return _mm256_xor_ps(_mm256_set1_ps(-0.0f), a); }
+        static inline V fmadd(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+        static inline V cmpgt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        static inline V cmpge(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+        static inline V cmplt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        static inline V and_(V a, V b) { return _mm256_and_ps(a, b); }
+        static inline V or_(V a, V b) { return _mm256_or_ps(a, b); }
+        static inline V andnot(V m, V v) { return _mm256_andnot_ps(m, v); }
+        static inline V select(V m, V a, V b) { return _mm256_blendv_ps(b, a, m); }
+        static inline int movemask(V m) { return _mm256_movemask_ps(m); }
+
+        static const size_t SALT_WIDTH = 16;
+        static inline int live_salts(const uint16_t *p) {
+            __m256i salts = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i free = _mm256_or_si256(_mm256_cmpeq_epi16(salts, _mm256_setzero_si256()), _mm256_cmpeq_epi16(salts, _mm256_set1_epi16(-1)));
+
+            // Packing works within each 128-bit half, so the salts end up in bytes 0-7 and 16-23.
+            int bytes = _mm256_movemask_epi8(_mm256_packs_epi16(free, _mm256_setzero_si256()));
+            return ~((bytes & 0xFF) | ((bytes >> 8) & 0xFF00)) & 0xFFFF;
+        }
+    };
+}
+
+#include "batch_kernels.h"
+
+const BatchFunctions batch_functions_avx2 = BATCH_KERNELS;
+
+#endif
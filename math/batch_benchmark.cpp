@@ -0,0 +1,121 @@
+// Time each batch math function with every instruction set the CPU supports.
+//
+// Usage: batch_benchmark [-n iterations]
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "batch.h"
+
+// About as many nodes as every object in a busy game
+#define ELEMENT_COUNT 4096
+
+struct Node {
+    float scale;
+    Quaternion rotation;
+    Vector3D position;
+};
+
+static float random_float(float low, float high) noexcept {
+    return low + (high - low) * (static_cast<float>(rand()) / RAND_MAX);
+}
+
+static void random_quaternion(Quaternion &q) noexcept {
+    q.x = random_float(-1, 1);
+    q.y = random_float(-1, 1);
+    q.z = random_float(-1, 1);
+    q.w = random_float(-1, 1);
+    float length = sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    q.x /= length;
+    q.y /= length;
+    q.z /= length;
+    q.w /= length;
+}
+
+struct Data {
+    std::vector<Node> before, after, output;
+    std::vector<Vector3D> vectors;
+    std::vector<float> distances;
+    std::vector<RotationMatrix> matrices;
+    std::vector<uint16_t> salts;
+    std::vector<uint32_t> mask;
+
+    Data() noexcept {
+        for(size_t i = 0; i < ELEMENT_COUNT; i++) {
+            Node node;
+            node.scale = random_float(0.5f, 2);
+            random_quaternion(node.rotation);
+            node.position = Vector3D { random_float(-10, 10), random_float(-10, 10), random_float(-10, 10) };
+            this->before.push_back(node);
+            random_quaternion(node.rotation);
+            this->after.push_back(node);
+            this->vectors.push_back(node.position);
+            this->salts.push_back(rand() % 3 == 0 ? 0xFFFF : 0xE000 + i);
+        }
+        this->output = this->before;
+        this->distances.resize(ELEMENT_COUNT);
+        this->matrices.resize(ELEMENT_COUNT);
+        this->mask.resize((ELEMENT_COUNT + 31) / 32);
+    }
+};
+
+template<typename F>
+static double time_function(int iterations, F function) noexcept {
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++) {
+        function();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations / ELEMENT_COUNT;
+}
+
+#define node_span(type, vector, member) Span<type>(&(vector)[0].member, ELEMENT_COUNT, sizeof(Node))
+
+int main(int argc, const char **argv) {
+    int iterations = 2000;
+    if(argc == 3 && strcmp(argv[1], "-n") == 0) {
+        iterations = atoi(argv[2]);
+    }
+    if((argc != 1 && argc != 3) || iterations <= 0) {
+        fprintf(stderr, "Usage: %s [-n iterations]\n", argv[0]);
+        return 1;
+    }
+
+    static const char *names[] = { "scalar", "SSE2", "AVX2" };
+    Data data;
+
+    printf("%-24s", "ns per element");
+    for(int i = BATCH_INSTRUCTION_SET_SCALAR; i <= BATCH_INSTRUCTION_SET_AVX2; i++) {
+        printf("%10s", names[i]);
+    }
+    printf("\n");
+
+    struct Benchmark {
+        const char *name;
+        void (*function)(Data &data);
+    } benchmarks[] = {
+        { "lerp (strided vector)", [](Data &data) { batch_lerp(node_span(const Vector3D, data.before, position), node_span(const Vector3D, data.after, position), node_span(Vector3D, data.output, position), 0.5f); } },
+        { "slerp (strided)", [](Data &data) { batch_slerp(node_span(const Quaternion, data.before, rotation), node_span(const Quaternion, data.after, rotation), node_span(Quaternion, data.output, rotation), 0.5f); } },
+        { "normalize (vector)", [](Data &data) { batch_normalize(Span<Vector3D>(data.vectors.data(), ELEMENT_COUNT)); } },
+        { "distance_squared", [](Data &data) { batch_distance_squared(data.vectors[0], Span<const Vector3D>(data.vectors.data(), ELEMENT_COUNT), Span<float>(data.distances.data(), ELEMENT_COUNT)); } },
+        { "quaternion_to_matrix", [](Data &data) { batch_quaternion_to_matrix(node_span(const Quaternion, data.before, rotation), Span<RotationMatrix>(data.matrices.data(), ELEMENT_COUNT)); } },
+        { "matrix_to_quaternion", [](Data &data) { batch_matrix_to_quaternion(Span<const RotationMatrix>(data.matrices.data(), ELEMENT_COUNT), node_span(Quaternion, data.output, rotation)); } },
+        { "live_slots", [](Data &data) { batch_live_slots(Span<const uint16_t>(data.salts.data(), ELEMENT_COUNT), data.mask.data()); } }
+    };
+
+    for(auto &benchmark : benchmarks) {
+        printf("%-24s", benchmark.name);
+        for(int i = BATCH_INSTRUCTION_SET_SCALAR; i <= BATCH_INSTRUCTION_SET_AVX2; i++) {
+            auto instruction_set = static_cast<BatchInstructionSet>(i);
+            if(batch_set_instruction_set(instruction_set) != instruction_set) {
+                printf("%10s", "-");
+                continue;
+            }
+            printf("%10.2f", time_function(iterations, [&]() { benchmark.function(data); }));
+        }
+        printf("\n");
+    }
+    return 0;
+}
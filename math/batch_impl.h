@@ -0,0 +1,46 @@
+#pragma once
+
+// This header is shared by the batch math implementations. It deliberately only uses raw floats (and raw 16-bit salts)
+// so the SSE2 and AVX2 translation units (which are compiled with different instruction set flags) don't instantiate
+// any inline functions that could end up being shared with code that runs on any CPU.
+//
+// All strides are in elements, not bytes.
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct BatchFunctions {
+    /// Interpolate count elements of components floats each. If predict is set, the delta is added to after.
+    void (*lerp)(const float *before, size_t before_stride, const float *after, size_t after_stride, float *output, size_t output_stride, size_t count, size_t components, float scale, bool predict);
+
+    /// Interpolate count structure-of-arrays 3D vectors and scale each to radius.
+    void (*nlerp)(const float *const before[3], const float *const after[3], const float *radius, float *const output[3], size_t count, float scale);
+
+    /// Slerp count quaternions, leaving the output untouched for pairs that can't be interpolated.
+    void (*slerp)(const float *before, size_t before_stride, const float *after, size_t after_stride, float *output, size_t output_stride, size_t count, float scale);
+
+    /// Normalize count vectors of components (3 or 4) floats each in place.
+    void (*normalize)(float *vectors, size_t stride, size_t count, size_t components);
+
+    /// Write the squared distance from point to each of count 3D points to output (contiguous).
+    void (*distance_squared)(const float *point, const float *points, size_t stride, size_t count, float *output);
+
+    /// Convert count quaternions (x, y, z, w) to rotation matrices (9 floats; v[0].x through v[2].z).
+    void (*quaternion_to_matrix)(const float *quaternions, size_t quaternion_stride, float *matrices, size_t matrix_stride, size_t count);
+
+    /// Convert count rotation matrices to quaternions.
+    void (*matrix_to_quaternion)(const float *matrices, size_t matrix_stride, float *quaternions, size_t quaternion_stride, size_t count);
+
+    /// Set bit i % 32 of mask[i / 32] if salt i is live (neither 0 nor 0xFFFF) and clear it if not. Every mask word
+    /// touched is overwritten.
+    void (*live_slots)(const uint16_t *salts, size_t stride, size_t count, uint32_t *mask);
+};
+
+/// Reference implementation. The SIMD implementations also use it to handle any leftover elements.
+extern const BatchFunctions batch_functions_scalar;
+
+/// SSE2 implementation (batch_sse2.cpp)
+extern const BatchFunctions batch_functions_sse2;
+
+/// AVX2 + FMA implementation (batch_avx2.cpp)
+extern const BatchFunctions batch_functions_avx2;
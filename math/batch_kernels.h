@@ -0,0 +1,345 @@
+#pragma once
+
+// Batch math kernels shared by the SIMD implementations. Each translation unit that includes this defines a lane type L
+// in an anonymous namespace before including it:
+//
+//   V                      vector of WIDTH floats
+//   set1, load, store      broadcast, contiguous load and store
+//   gather, scatter        strided load and store (stride in floats)
+//   add, sub, mul, div, sqrt, min, max, abs, neg
+//   fmadd(a, b, c)         a * b + c
+//   cmpgt, cmpge, cmplt    comparison masks
+//   and_, or_, andnot(m, v) (~m & v)
+//   select(m, a, b)        m ? a : b per lane
+//   movemask(m)            one bit per lane
+//   SALT_WIDTH             number of 16-bit salts checked at once (8 or 16)
+//   live_salts(p)          one bit per packed salt that is neither 0 nor 0xFFFF
+//
+// Everything here has internal linkage so code compiled for one instruction set can never be picked up by another
+// translation unit. Leftover elements are handed to batch_functions_scalar.
+
+#include "batch_impl.h"
+
+#if defined(__GNUC__) && defined(__i386__)
+// Halo doesn't keep the stack 16-byte aligned, so realign it on the way in before anything gets spilled.
+#define BATCH_ENTRY __attribute__((force_align_arg_pointer))
+#else
+#define BATCH_ENTRY
+#endif
+
+namespace {
+    #define W L::WIDTH
+    typedef L::V V;
+
+    BATCH_ENTRY void kernel_lerp(const float *before, size_t before_stride, const float *after, size_t after_stride, float *output, size_t output_stride, size_t count, size_t components, float scale, bool predict) {
+        V s = L::set1(scale);
+        size_t i = 0;
+
+        // Contiguous arrays can be treated as one long array of floats.
+        if(before_stride == components && after_stride == components && output_stride == components) {
+            size_t total = count * components;
+            for(; i + W <= total; i += W) {
+                V b = L::load(before + i);
+                V a = L::load(after + i);
+                L::store(output + i, L::fmadd(L::sub(a, b), s, predict ? a : b));
+            }
+            batch_functions_scalar.lerp(before + i, 1, after + i, 1, output + i, 1, total - i, 1, scale, predict);
+            return;
+        }
+
+        for(; i + W <= count; i += W) {
+            for(size_t c = 0; c < components; c++) {
+                V b = L::gather(before + i * before_stride + c, before_stride);
+                V a = L::gather(after + i * after_stride + c, after_stride);
+                L::scatter(output + i * output_stride + c, output_stride, L::fmadd(L::sub(a, b), s, predict ? a : b));
+            }
+        }
+        batch_functions_scalar.lerp(before + i * before_stride, before_stride, after + i * after_stride, after_stride, output + i * output_stride, output_stride, count - i, components, scale, predict);
+    }
+
+    BATCH_ENTRY void kernel_nlerp(const float *const before[3], const float *const after[3], const float *radius, float *const output[3], size_t count, float scale) {
+        V s = L::set1(scale);
+        V one = L::set1(1.0f);
+        V tiny = L::set1(1.0E-30f);
+        V zero = L::set1(0.0f);
+        size_t i = 0;
+        for(; i + W <= count; i += W) {
+            V x = L::load(before[0] + i);
+            V y = L::load(before[1] + i);
+            V z = L::load(before[2] + i);
+            x = L::fmadd(L::sub(L::load(after[0] + i), x), s, x);
+            y = L::fmadd(L::sub(L::load(after[1] + i), y), s, y);
+            z = L::fmadd(L::sub(L::load(after[2] + i), z), s, z);
+
+            V length_squared = L::fmadd(z, z, L::fmadd(y, y, L::mul(x, x)));
+            V factor = L::select(L::cmpgt(length_squared, zero), L::div(L::load(radius + i), L::sqrt(L::max(length_squared, tiny))), one);
+
+            L::store(output[0] + i, L::mul(x, factor));
+            L::store(output[1] + i, L::mul(y, factor));
+            L::store(output[2] + i, L::mul(z, factor));
+        }
+
+        if(i < count) {
+            const float *const b[3] = { before[0] + i, before[1] + i, before[2] + i };
+            const float *const a[3] = { after[0] + i, after[1] + i, after[2] + i };
+            float *const o[3] = { output[0] + i, output[1] + i, output[2] + i };
+            batch_functions_scalar.nlerp(b, a, radius + i, o, count - i, scale);
+        }
+    }
+
+    // acos for x in [0, 1] (Abramowitz and Stegun 4.4.46; absolute error < 2E-8)
+    inline V acos_01(V x) {
+        V p = L::set1(-0.0012624911f);
+        p = L::fmadd(p, x, L::set1(0.0066700901f));
+        p = L::fmadd(p, x, L::set1(-0.0170881256f));
+        p = L::fmadd(p, x, L::set1(0.0308918810f));
+        p = L::fmadd(p, x, L::set1(-0.0501743046f));
+        p = L::fmadd(p, x, L::set1(0.0889789874f));
+        p = L::fmadd(p, x, L::set1(-0.2145988016f));
+        p = L::fmadd(p, x, L::set1(1.5707963050f));
+        return L::mul(p, L::sqrt(L::max(L::sub(L::set1(1.0f), x), L::set1(0.0f))));
+    }
+
+    // sin for x in [0, pi/2] (Taylor series to x^11)
+    inline V sin_0pi2(V x) {
+        V x2 = L::mul(x, x);
+        V p = L::set1(-1.0f / 39916800.0f);
+        p = L::fmadd(p, x2, L::set1(1.0f / 362880.0f));
+        p = L::fmadd(p, x2, L::set1(-1.0f / 5040.0f));
+        p = L::fmadd(p, x2, L::set1(1.0f / 120.0f));
+        p = L::fmadd(p, x2, L::set1(-1.0f / 6.0f));
+        p = L::fmadd(p, x2, L::set1(1.0f));
+        return L::mul(p, x);
+    }
+
+    BATCH_ENTRY void kernel_slerp(const float *before, size_t before_stride, const float *after, size_t after_stride, float *output, size_t output_stride, size_t count, float scale) {
+        V s = L::set1(scale);
+        V s_inverse = L::set1(1.0f - scale);
+        V zero = L::set1(0.0f);
+        V one = L::set1(1.0f);
+        V min_cos = L::set1(0.01f);
+        V min_sin = L::set1(0.00001f);
+        const int all_lanes = (1 << W) - 1;
+
+        size_t i = 0;
+        for(; i + W <= count; i += W) {
+            const float *b = before + i * before_stride;
+            const float *a = after + i * after_stride;
+            float *o = output + i * output_stride;
+
+            V bq[4], aq[4];
+            for(size_t c = 0; c < 4; c++) {
+                bq[c] = L::gather(b + c, before_stride);
+                aq[c] = L::gather(a + c, after_stride);
+            }
+
+            V cos_half_theta = L::fmadd(bq[3], aq[3], L::fmadd(bq[2], aq[2], L::fmadd(bq[1], aq[1], L::mul(bq[0], aq[0]))));
+            V negative = L::cmplt(cos_half_theta, zero);
+            cos_half_theta = L::abs(cos_half_theta);
+
+            int valid = L::movemask(L::cmpge(cos_half_theta, min_cos));
+            if(valid == 0) continue;
+            cos_half_theta = L::min(cos_half_theta, one);
+
+            V sin_half_theta = L::sqrt(L::max(L::sub(one, L::mul(cos_half_theta, cos_half_theta)), zero));
+            V half_theta = acos_01(cos_half_theta);
+            V sin_inverse = L::div(one, L::max(sin_half_theta, min_sin));
+            V use_sin = L::cmpgt(sin_half_theta, min_sin);
+            V r0 = L::select(use_sin, L::mul(sin_0pi2(L::mul(s_inverse, half_theta)), sin_inverse), s_inverse);
+            V r1 = L::select(use_sin, L::mul(sin_0pi2(L::mul(s, half_theta)), sin_inverse), s);
+            r1 = L::select(negative, L::neg(r1), r1);
+
+            V result[4];
+            for(size_t c = 0; c < 4; c++) {
+                result[c] = L::fmadd(aq[c], r1, L::mul(bq[c], r0));
+            }
+
+            if(valid == all_lanes) {
+                for(size_t c = 0; c < 4; c++) {
+                    L::scatter(o + c, output_stride, result[c]);
+                }
+            }
+            else {
+                // Leave the output untouched for pairs that can't be interpolated.
+                alignas(32) float lanes[4][W];
+                for(size_t c = 0; c < 4; c++) {
+                    L::store(lanes[c], result[c]);
+                }
+                for(size_t l = 0; l < W; l++) {
+                    if(!(valid & (1 << l))) continue;
+                    for(size_t c = 0; c < 4; c++) {
+                        o[l * output_stride + c] = lanes[c][l];
+                    }
+                }
+            }
+        }
+        batch_functions_scalar.slerp(before + i * before_stride, before_stride, after + i * after_stride, after_stride, output + i * output_stride, output_stride, count - i, scale);
+    }
+
+    BATCH_ENTRY void kernel_normalize(float *vectors, size_t stride, size_t count, size_t components) {
+        V zero = L::set1(0.0f);
+        V one = L::set1(1.0f);
+        V tiny = L::set1(1.0E-30f);
+        size_t i = 0;
+        for(; i + W <= count; i += W) {
+            float *v = vectors + i * stride;
+            V c[4];
+            V length_squared = zero;
+            for(size_t n = 0; n < components; n++) {
+                c[n] = L::gather(v + n, stride);
+                length_squared = L::fmadd(c[n], c[n], length_squared);
+            }
+            V factor = L::select(L::cmpgt(length_squared, zero), L::div(one, L::sqrt(L::max(length_squared, tiny))), one);
+            for(size_t n = 0; n < components; n++) {
+                L::scatter(v + n, stride, L::mul(c[n], factor));
+            }
+        }
+        batch_functions_scalar.normalize(vectors + i * stride, stride, count - i, components);
+    }
+
+    BATCH_ENTRY void kernel_distance_squared(const float *point, const float *points, size_t stride, size_t count, float *output) {
+        V px = L::set1(point[0]);
+        V py = L::set1(point[1]);
+        V pz = L::set1(point[2]);
+        size_t i = 0;
+        for(; i + W <= count; i += W) {
+            const float *p = points + i * stride;
+            V dx = L::sub(L::gather(p, stride), px);
+            V dy = L::sub(L::gather(p + 1, stride), py);
+            V dz = L::sub(L::gather(p + 2, stride), pz);
+            L::store(output + i, L::fmadd(dz, dz, L::fmadd(dy, dy, L::mul(dx, dx))));
+        }
+        batch_functions_scalar.distance_squared(point, points + i * stride, stride, count - i, output + i);
+    }
+
+    // Same formulas as RotationMatrix(const Quaternion &)
+    BATCH_ENTRY void kernel_quaternion_to_matrix(const float *quaternions, size_t quaternion_stride, float *matrices, size_t matrix_stride, size_t count) {
+        V two = L::set1(2.0f);
+        size_t i = 0;
+        for(; i + W <= count; i += W) {
+            const float *q = quaternions + i * quaternion_stride;
+            float *m = matrices + i * matrix_stride;
+            V x = L::gather(q + 0, quaternion_stride);
+            V y = L::gather(q + 1, quaternion_stride);
+            V z = L::gather(q + 2, quaternion_stride);
+            V w = L::gather(q + 3, quaternion_stride);
+
+            V sqx = L::mul(x, x);
+            V sqy = L::mul(y, y);
+            V sqz = L::mul(z, z);
+            V sqw = L::mul(w, w);
+            V invs = L::div(L::set1(1.0f), L::add(L::add(sqx, sqy), L::add(sqz, sqw)));
+            V invs2 = L::mul(invs, two);
+
+            L::scatter(m + 0, matrix_stride, L::mul(L::add(L::sub(sqx, sqy), L::sub(sqw, sqz)), invs));
+            L::scatter(m + 4, matrix_stride, L::mul(L::add(L::sub(sqy, sqx), L::sub(sqw, sqz)), invs));
+            L::scatter(m + 8, matrix_stride, L::mul(L::add(L::sub(sqz, sqx), L::sub(sqw, sqy)), invs));
+
+            V tmp1 = L::mul(x, y);
+            V tmp2 = L::mul(z, w);
+            L::scatter(m + 3, matrix_stride, L::mul(L::add(tmp1, tmp2), invs2));
+            L::scatter(m + 1, matrix_stride, L::mul(L::sub(tmp1, tmp2), invs2));
+
+            tmp1 = L::mul(x, z);
+            tmp2 = L::mul(y, w);
+            L::scatter(m + 6, matrix_stride, L::mul(L::sub(tmp1, tmp2), invs2));
+            L::scatter(m + 2, matrix_stride, L::mul(L::add(tmp1, tmp2), invs2));
+
+            tmp1 = L::mul(y, z);
+            tmp2 = L::mul(x, w);
+            L::scatter(m + 7, matrix_stride, L::mul(L::add(tmp1, tmp2), invs2));
+            L::scatter(m + 5, matrix_stride, L::mul(L::sub(tmp1, tmp2), invs2));
+        }
+        batch_functions_scalar.quaternion_to_matrix(quaternions + i * quaternion_stride, quaternion_stride, matrices + i * matrix_stride, matrix_stride, count - i);
+    }
+
+    // Same cases as Quaternion(const RotationMatrix &), but all four are computed and the right one is selected per lane.
+    BATCH_ENTRY void kernel_matrix_to_quaternion(const float *matrices, size_t matrix_stride, float *quaternions, size_t quaternion_stride, size_t count) {
+        V zero = L::set1(0.0f);
+        V one = L::set1(1.0f);
+        V quarter = L::set1(0.25f);
+        size_t i = 0;
+        for(; i + W <= count; i += W) {
+            const float *m = matrices + i * matrix_stride;
+            float *q = quaternions + i * quaternion_stride;
+            V m00 = L::gather(m + 0, matrix_stride);
+            V m01 = L::gather(m + 1, matrix_stride);
+            V m02 = L::gather(m + 2, matrix_stride);
+            V m10 = L::gather(m + 3, matrix_stride);
+            V m11 = L::gather(m + 4, matrix_stride);
+            V m12 = L::gather(m + 5, matrix_stride);
+            V m20 = L::gather(m + 6, matrix_stride);
+            V m21 = L::gather(m + 7, matrix_stride);
+            V m22 = L::gather(m + 8, matrix_stride);
+
+            V case_w = L::cmpgt(L::add(L::add(m00, m11), m22), zero);
+            V case_x = L::and_(L::cmpgt(m00, m11), L::cmpgt(m00, m22));
+            V case_y = L::cmpgt(m11, m22);
+
+            V t_w = L::add(one, L::add(L::add(m00, m11), m22));
+            V t_x = L::add(one, L::sub(L::sub(m00, m11), m22));
+            V t_y = L::add(one, L::sub(L::sub(m11, m00), m22));
+            V t_z = L::add(one, L::sub(L::sub(m22, m00), m11));
+            V t = L::select(case_w, t_w, L::select(case_x, t_x, L::select(case_y, t_y, t_z)));
+
+            V s = L::mul(L::sqrt(L::max(t, zero)), L::set1(2.0f));
+            V s_inverse = L::div(one, s);
+            V major = L::mul(s, quarter);
+
+            V d_x = L::mul(L::sub(m21, m12), s_inverse);
+            V d_y = L::mul(L::sub(m02, m20), s_inverse);
+            V d_z = L::mul(L::sub(m10, m01), s_inverse);
+            V s_xy = L::mul(L::add(m01, m10), s_inverse);
+            V s_xz = L::mul(L::add(m02, m20), s_inverse);
+            V s_yz = L::mul(L::add(m12, m21), s_inverse);
+
+            V qx = L::select(case_w, d_x, L::select(case_x, major, L::select(case_y, s_xy, s_xz)));
+            V qy = L::select(case_w, d_y, L::select(case_x, s_xy, L::select(case_y, major, s_yz)));
+            V qz = L::select(case_w, d_z, L::select(case_x, s_xz, L::select(case_y, s_yz, major)));
+            V qw = L::select(case_w, major, L::select(case_x, d_x, L::select(case_y, d_y, d_z)));
+
+            L::scatter(q + 0, quaternion_stride, qx);
+            L::scatter(q + 1, quaternion_stride, qy);
+            L::scatter(q + 2, quaternion_stride, qz);
+            L::scatter(q + 3, quaternion_stride, qw);
+        }
+        batch_functions_scalar.matrix_to_quaternion(matrices + i * matrix_stride, matrix_stride, quaternions + i * quaternion_stride, quaternion_stride, count - i);
+    }
+
+    BATCH_ENTRY void kernel_live_slots(const uint16_t *salts, size_t stride, size_t count, uint32_t *mask) {
+        // Gathering strided salts into a vector costs more than checking them one at a time, so only packed salts are
+        // worth vectorizing.
+        if(stride != 1) {
+            batch_functions_scalar.live_slots(salts, stride, count, mask);
+            return;
+        }
+
+        // SALT_WIDTH divides 32, so each group of salts lands in a single mask word.
+        for(size_t i = 0; i < count; i += 32) {
+            size_t end = count - i < 32 ? count - i : 32;
+            uint32_t word = 0;
+            size_t j = 0;
+            for(; j + L::SALT_WIDTH <= end; j += L::SALT_WIDTH) {
+                word |= static_cast<uint32_t>(L::live_salts(salts + i + j)) << j;
+            }
+            for(; j < end; j++) {
+                uint16_t salt = salts[i + j];
+                word |= static_cast<uint32_t>(salt != 0 && salt != 0xFFFF) << j;
+            }
+            mask[i / 32] = word;
+        }
+    }
+
+    #undef W
+}
+
+#define BATCH_KERNELS { \
+    kernel_lerp, \
+    kernel_nlerp, \
+    kernel_slerp, \
+    kernel_normalize, \
+    kernel_distance_squared, \
+    kernel_quaternion_to_matrix, \
+    kernel_matrix_to_quaternion, \
+    kernel_live_slots \
+}
@@ -0,0 +1,60 @@
+// This file is compiled with SSE2 enabled. Nothing in it may be called unless the CPU supports SSE2 (see batch.cpp).
+
+#include "batch_impl.h"
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+
+#include <emmintrin.h>
+
+namespace {
+    struct L {
+        typedef __m128 V;
+        static const size_t WIDTH = 4;
+
+        static inline V set1(float f) { return _mm_set1_ps(f); }
+        static inline V load(const float *p) { return _mm_loadu_ps(p); }
+        static inline void store(float *p, V v) { _mm_storeu_ps(p, v); }
+        static inline V gather(const float *p, size_t stride) {
+            if(stride == 1) return _mm_loadu_ps(p);
+            return _mm_set_ps(p[stride * 3], p[stride * 2], p[stride], p[0]);
+        }
+        static inline void scatter(float *p, size_t stride, V v) {
+            if(stride == 1) return _mm_storeu_ps(p, v);
+            p[0] = _mm_cvtss_f32(v);
+            p[stride] = _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1,1,1,1)));
+            p[stride * 2] = _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2,2,2,2)));
+            p[stride * 3] = _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3,3,3,3)));
+        }
+        static inline V add(V a, V b) { return _mm_add_ps(a, b); }
+        static inline V sub(V a, V b) { return _mm_sub_ps(a, b); }
+        static inline V mul(V a, V b) { return _mm_mul_ps(a, b); }
+        static inline V div(V a, V b) { return _mm_div_ps(a, b); }
+        static inline V sqrt(V a) { return _mm_sqrt_ps(a); }
+        static inline V min(V a, V b) { return _mm_min_ps(a, b); }
+        static inline V max(V a, V b) { return _mm_max_ps(a, b); }
+        static inline V abs(V a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+        static inline V neg(V a) { return _mm_xor_ps(_mm_set1_ps(-0.0f), a); }
+        static inline V fmadd(V a, V b, V c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+        static inline V cmpgt(V a, V b) { return _mm_cmpgt_ps(a, b); }
+        static inline V cmpge(V a, V b) { return _mm_cmpge_ps(a, b); }
+        static inline V cmplt(V a, V b) { return _mm_cmplt_ps(a, b); }
+        static inline V and_(V a, V b) { return _mm_and_ps(a, b); }
+        static inline V or_(V a, V b) { return _mm_or_ps(a, b); }
+        static inline V andnot(V m, V v) { return _mm_andnot_ps(m, v); }
+        static inline V select(V m, V a, V b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+        static inline int movemask(V m) { return _mm_movemask_ps(m); }
+
+        static const size_t SALT_WIDTH = 8;
+        static inline int live_salts(const uint16_t *p) {
+            __m128i salts = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i free = _mm_or_si128(_mm_cmpeq_epi16(salts, _mm_setzero_si128()), _mm_cmpeq_epi16(salts, _mm_set1_epi16(-1)));
+            return ~_mm_movemask_epi8(_mm_packs_epi16(free, _mm_setzero_si128())) & 0xFF;
+        }
+    };
+}
+
+#include "batch_kernels.h"
+
+const BatchFunctions batch_functions_sse2 = BATCH_KERNELS;
+
+#endif
@@ -0,0 +1,227 @@
+// Check that every SIMD implementation of the batch math functions matches the scalar reference.
+//
+// Usage: batch_test
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "batch.h"
+
+// Odd counts and strided spans make sure leftover elements and gathers/scatters are covered, too.
+#define ELEMENT_COUNT 1037
+
+struct Node {
+    float scale;
+    Quaternion rotation;
+    Vector3D position;
+};
+
+struct Inputs {
+    std::vector<float> floats_before, floats_after, radius;
+    std::vector<Vector3D> vectors_before, vectors_after;
+    std::vector<Node> nodes_before, nodes_after;
+    std::vector<float> soa_before[3], soa_after[3];
+    std::vector<RotationMatrix> matrices;
+    std::vector<uint16_t> salts;
+};
+
+struct Outputs {
+    std::vector<float> floats, floats_predict, distances;
+    std::vector<Vector3D> vectors, vectors_predict, normalized;
+    std::vector<Node> nodes;
+    std::vector<Quaternion> quaternions, normalized_quaternions;
+    std::vector<float> soa[3];
+    std::vector<RotationMatrix> matrices;
+    std::vector<uint32_t> mask;
+};
+
+static float random_float(float low, float high) noexcept {
+    return low + (high - low) * (static_cast<float>(rand()) / RAND_MAX);
+}
+
+static void random_quaternion(Quaternion &q) noexcept {
+    q.x = random_float(-1, 1);
+    q.y = random_float(-1, 1);
+    q.z = random_float(-1, 1);
+    q.w = random_float(-1, 1);
+    float length = sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    q.x /= length;
+    q.y /= length;
+    q.z /= length;
+    q.w /= length;
+}
+
+static Vector3D random_vector(float range) noexcept {
+    Vector3D v;
+    v.x = random_float(-range, range);
+    v.y = random_float(-range, range);
+    v.z = random_float(-range, range);
+    return v;
+}
+
+static void make_inputs(Inputs &inputs) noexcept {
+    srand(1234);
+    for(size_t i = 0; i < ELEMENT_COUNT; i++) {
+        inputs.floats_before.push_back(random_float(-100, 100));
+        inputs.floats_after.push_back(random_float(-100, 100));
+        inputs.radius.push_back(random_float(0.1f, 10));
+        inputs.vectors_before.push_back(random_vector(100));
+        inputs.vectors_after.push_back(random_vector(100));
+
+        Node before, after;
+        before.scale = random_float(0.5f, 2);
+        after.scale = random_float(0.5f, 2);
+        random_quaternion(before.rotation);
+        random_quaternion(after.rotation);
+        before.position = random_vector(10);
+        after.position = random_vector(10);
+        inputs.nodes_before.push_back(before);
+        inputs.nodes_after.push_back(after);
+
+        for(size_t c = 0; c < 3; c++) {
+            inputs.soa_before[c].push_back(random_float(-1, 1));
+            inputs.soa_after[c].push_back(random_float(-1, 1));
+        }
+
+        // A few zero-length vectors check that they're left untouched.
+        if(i % 97 == 0) {
+            inputs.vectors_before[i] = Vector3D { 0, 0, 0 };
+        }
+
+        Quaternion rotation;
+        random_quaternion(rotation);
+        inputs.matrices.push_back(RotationMatrix(rotation));
+
+        static const uint16_t salt_values[] = { 0, 0xFFFF, 0xE001, 0x8000, 1 };
+        inputs.salts.push_back(salt_values[rand() % 5]);
+    }
+}
+
+static void run(const Inputs &inputs, Outputs &outputs) noexcept {
+    size_t n = ELEMENT_COUNT;
+
+    outputs.floats.assign(n, 0);
+    outputs.floats_predict.assign(n, 0);
+    batch_lerp(Span<const float>(inputs.floats_before.data(), n), Span<const float>(inputs.floats_after.data(), n), Span<float>(outputs.floats.data(), n), 0.3f);
+    batch_lerp_predict(Span<const float>(inputs.floats_before.data(), n), Span<const float>(inputs.floats_after.data(), n), Span<float>(outputs.floats_predict.data(), n), 0.3f);
+
+    outputs.vectors.assign(n, Vector3D());
+    outputs.vectors_predict.assign(n, Vector3D());
+    batch_lerp(Span<const Vector3D>(inputs.vectors_before.data(), n), Span<const Vector3D>(inputs.vectors_after.data(), n), Span<Vector3D>(outputs.vectors.data(), n), 0.7f);
+    batch_lerp_predict(Span<const Vector3D>(inputs.vectors_before.data(), n), Span<const Vector3D>(inputs.vectors_after.data(), n), Span<Vector3D>(outputs.vectors_predict.data(), n), 0.7f);
+
+    // Interpolate each member of the nodes in place.
+    outputs.nodes = inputs.nodes_before;
+    batch_lerp(Span<const float>(&inputs.nodes_before[0].scale, n, sizeof(Node)), Span<const float>(&inputs.nodes_after[0].scale, n, sizeof(Node)), Span<float>(&outputs.nodes[0].scale, n, sizeof(Node)), 0.5f);
+    batch_lerp(Span<const Vector3D>(&inputs.nodes_before[0].position, n, sizeof(Node)), Span<const Vector3D>(&inputs.nodes_after[0].position, n, sizeof(Node)), Span<Vector3D>(&outputs.nodes[0].position, n, sizeof(Node)), 0.5f);
+    batch_slerp(Span<const Quaternion>(&inputs.nodes_before[0].rotation, n, sizeof(Node)), Span<const Quaternion>(&inputs.nodes_after[0].rotation, n, sizeof(Node)), Span<Quaternion>(&outputs.nodes[0].rotation, n, sizeof(Node)), 0.5f);
+
+    for(size_t c = 0; c < 3; c++) {
+        outputs.soa[c].assign(n, 0);
+    }
+    Vector3DSoA before = { const_cast<float *>(inputs.soa_before[0].data()), const_cast<float *>(inputs.soa_before[1].data()), const_cast<float *>(inputs.soa_before[2].data()) };
+    Vector3DSoA after = { const_cast<float *>(inputs.soa_after[0].data()), const_cast<float *>(inputs.soa_after[1].data()), const_cast<float *>(inputs.soa_after[2].data()) };
+    Vector3DSoA output = { outputs.soa[0].data(), outputs.soa[1].data(), outputs.soa[2].data() };
+    batch_nlerp(before, after, Span<const float>(inputs.radius.data(), n), output, 0.4f);
+
+    outputs.normalized = inputs.vectors_before;
+    batch_normalize(Span<Vector3D>(outputs.normalized.data(), n));
+
+    outputs.normalized_quaternions.clear();
+    for(auto &node : inputs.nodes_before) {
+        Quaternion q = node.rotation;
+        q.x *= node.scale;
+        q.y *= node.scale;
+        q.z *= node.scale;
+        q.w *= node.scale;
+        outputs.normalized_quaternions.push_back(q);
+    }
+    batch_normalize(Span<Quaternion>(outputs.normalized_quaternions.data(), n));
+
+    outputs.distances.assign(n, 0);
+    batch_distance_squared(inputs.vectors_after[0], Span<const Vector3D>(inputs.vectors_before.data(), n), Span<float>(outputs.distances.data(), n));
+
+    outputs.matrices.assign(n, RotationMatrix());
+    batch_quaternion_to_matrix(Span<const Quaternion>(&inputs.nodes_after[0].rotation, n, sizeof(Node)), Span<RotationMatrix>(outputs.matrices.data(), n));
+
+    outputs.quaternions.assign(n, Quaternion());
+    batch_matrix_to_quaternion(Span<const RotationMatrix>(inputs.matrices.data(), n), Span<Quaternion>(outputs.quaternions.data(), n));
+
+    outputs.mask.assign((n + 31) / 32, 0xCCCCCCCC);
+    batch_live_slots(Span<const uint16_t>(inputs.salts.data(), n), outputs.mask.data());
+}
+
+static size_t failures = 0;
+
+static void compare(const char *name, const float *expected, const float *actual, size_t count, size_t stride, size_t components, float tolerance) noexcept {
+    size_t mismatches = 0;
+    float worst = 0;
+    for(size_t i = 0; i < count; i++) {
+        for(size_t c = 0; c < components; c++) {
+            float e = expected[i * stride + c];
+            float a = actual[i * stride + c];
+            float error = fabs(e - a) / (fabs(e) > 1 ? fabs(e) : 1);
+            if(!(error <= tolerance)) {
+                if(mismatches == 0) fprintf(stderr, "    %s: element %zu expected %f, got %f\n", name, i, e, a);
+                mismatches++;
+            }
+            if(error > worst) worst = error;
+        }
+    }
+    printf("    %-24s %s (worst error %g)\n", name, mismatches ? "FAILED" : "ok", worst);
+    if(mismatches) failures++;
+}
+
+#define compare_vector(name, member, type, tolerance) compare(name, &expected.member[0].x, &actual.member[0].x, ELEMENT_COUNT, sizeof(type) / sizeof(float), sizeof(type) / sizeof(float), tolerance)
+
+static void compare_outputs(const Outputs &expected, const Outputs &actual) noexcept {
+    // FMA only rounds once, so lerps can differ by a few ulps of the inputs (which go up to 100) when the result is small.
+    compare("lerp (float)", expected.floats.data(), actual.floats.data(), ELEMENT_COUNT, 1, 1, 1.0E-5f);
+    compare("lerp_predict (float)", expected.floats_predict.data(), actual.floats_predict.data(), ELEMENT_COUNT, 1, 1, 1.0E-5f);
+    compare_vector("lerp (vector)", vectors, Vector3D, 1.0E-5f);
+    compare_vector("lerp_predict (vector)", vectors_predict, Vector3D, 1.0E-5f);
+    compare("lerp (strided)", &expected.nodes[0].scale, &actual.nodes[0].scale, ELEMENT_COUNT, sizeof(Node) / sizeof(float), sizeof(Node) / sizeof(float), 1.0E-5f);
+    for(size_t c = 0; c < 3; c++) {
+        compare("nlerp", expected.soa[c].data(), actual.soa[c].data(), ELEMENT_COUNT, 1, 1, 1.0E-5f);
+    }
+    compare_vector("normalize (vector)", normalized, Vector3D, 1.0E-6f);
+    compare_vector("normalize (quaternion)", normalized_quaternions, Quaternion, 1.0E-6f);
+    compare("distance_squared", expected.distances.data(), actual.distances.data(), ELEMENT_COUNT, 1, 1, 1.0E-6f);
+    compare("quaternion_to_matrix", &expected.matrices[0].v[0].x, &actual.matrices[0].v[0].x, ELEMENT_COUNT, 9, 9, 1.0E-5f);
+    compare_vector("matrix_to_quaternion", quaternions, Quaternion, 1.0E-5f);
+
+    bool masks_match = memcmp(expected.mask.data(), actual.mask.data(), expected.mask.size() * sizeof(uint32_t)) == 0;
+    printf("    %-24s %s\n", "live_slots", masks_match ? "ok" : "FAILED");
+    if(!masks_match) failures++;
+}
+
+int main() {
+    static const char *names[] = { "scalar", "SSE2", "AVX2" };
+
+    Inputs inputs;
+    make_inputs(inputs);
+
+    Outputs expected;
+    batch_set_instruction_set(BATCH_INSTRUCTION_SET_SCALAR);
+    run(inputs, expected);
+
+    for(int i = BATCH_INSTRUCTION_SET_SSE2; i <= BATCH_INSTRUCTION_SET_AVX2; i++) {
+        auto instruction_set = static_cast<BatchInstructionSet>(i);
+        if(batch_set_instruction_set(instruction_set) != instruction_set) {
+            printf("%s: not supported by this CPU; skipped\n", names[i]);
+            continue;
+        }
+        printf("%s:\n", names[i]);
+        Outputs actual;
+        run(inputs, actual);
+        compare_outputs(expected, actual);
+    }
+
+    if(failures) {
+        printf("%zu comparisons failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
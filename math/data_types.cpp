@@ -1,7 +1,9 @@
 #include <cmath>
 #include "data_types.h"
+#include "batch.h"
 
 interpolate_vector_fn interpolate_vector_objects = interpolate_vector;
+interpolate_floats_fn interpolate_floats_objects = interpolate_floats;
 
 ColorRGB::ColorRGB() noexcept {}
 
@@ -195,6 +197,10 @@ void interpolate_quat(const Quaternion &in_before, const Quaternion &in_after, Q
 	out.z = z0 * r1 + z1 * r0;
 }
 
+void interpolate_quat_batch(const Quaternion *before, const Quaternion *after, Quaternion *output, size_t count, float scale, size_t stride) noexcept {
+	batch_slerp(Span<const Quaternion>(before, count, stride), Span<const Quaternion>(after, count, stride), Span<Quaternion>(output, count, stride), scale);
+}
+
 void interpolate_vector_rotation(const Vector3D &before, const Vector3D &after, Vector3D &output, float scale) noexcept {
 	float radius = sqrt(before.x * before.x + before.y * before.y + before.z * before.z);
 	auto &xr = output.x;
@@ -245,6 +251,10 @@ void interpolate_vector_rotation(const Vector3D &before, const Vector3D &after,
 	}
 }
 
+void interpolate_vector_rotation_soa(const Vector3DSoA &before, const Vector3DSoA &after, const float *radius, const Vector3DSoA &output, size_t count, float scale) noexcept {
+	batch_nlerp(before, after, Span<const float>(radius, count), output, scale);
+}
+
 void interpolate_vector(const Vector3D &before, const Vector3D &after, Vector3D &output, float scale) noexcept {
 	output.x = before.x + (after.x - before.x) * scale;
 	output.y = before.y + (after.y - before.y) * scale;
@@ -257,6 +267,14 @@ void interpolate_vector_predict(const Vector3D &before, const Vector3D &after, V
 	output.z = after.z + (after.z - before.z) * scale;
 }
 
+void interpolate_floats(const float *before, const float *after, float *output, size_t count, float scale) noexcept {
+	batch_lerp(Span<const float>(before, count), Span<const float>(after, count), Span<float>(output, count), scale);
+}
+
+void interpolate_floats_predict(const float *before, const float *after, float *output, size_t count, float scale) noexcept {
+	batch_lerp_predict(Span<const float>(before, count), Span<const float>(after, count), Span<float>(output, count), scale);
+}
+
 float distance(float x1, float y1, float z1, float x2, float y2, float z2) noexcept {
 	return sqrt(distance_squared(x1, y1, z1, x2, y2, z2));
 }
@@ -286,6 +304,7 @@ float distance_squared(const Vector3D &a, const Vector3D &b) noexcept {
 	return distance_squared(a.x, a.y, a.z, b.x, b.y, b.z);
 }
 
+#ifdef _WIN32
 float  counter_time_elapsed(const LARGE_INTEGER &before) noexcept {
 	LARGE_INTEGER now;
 	QueryPerformanceCounter(&now);
@@ -299,3 +318,4 @@ float  counter_time_elapsed(const LARGE_INTEGER &before, const LARGE_INTEGER &af
 	}
 	return static_cast<float>(after.QuadPart - before.QuadPart) / performance_frequency.QuadPart;
 }
+#endif
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <stddef.h>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 #define STRA(x) #x
 #define STR(x) STRA(x)
@@ -99,9 +102,24 @@ struct RotationMatrix {
 /// Interpolate a quaternion.
 void interpolate_quat(const Quaternion &in_before, const Quaternion &in_after, Quaternion &out, float scale) noexcept;
 
+/// Interpolate count quaternions at once. stride is the distance in bytes between consecutive quaternions in each
+/// array, so quaternions can be interpolated in place inside arrays of larger structs.
+void interpolate_quat_batch(const Quaternion *before, const Quaternion *after, Quaternion *output, size_t count, float scale, size_t stride = sizeof(Quaternion)) noexcept;
+
 /// Interpolate a normalized 3D vector.
 void interpolate_vector_rotation(const Vector3D &before, const Vector3D &after, Vector3D &output, float scale) noexcept;
 
+/// Structure-of-arrays view of 3D vectors; each pointer refers to an array of the same length.
+struct Vector3DSoA {
+    float *x;
+    float *y;
+    float *z;
+};
+
+/// Interpolate count normalized 3D vectors at once, scaling each result to the given radius (typically the length of
+/// the before vector). This is a normalized lerp, so it only needs one square root per vector.
+void interpolate_vector_rotation_soa(const Vector3DSoA &before, const Vector3DSoA &after, const float *radius, const Vector3DSoA &output, size_t count, float scale) noexcept;
+
 typedef void (*interpolate_vector_fn)(const Vector3D&,const Vector3D&,Vector3D&,float);
 
 /// Interpolate a 3D vector.
@@ -111,6 +129,14 @@ void interpolate_vector(const Vector3D &before, const Vector3D &after, Vector3D
 /// "one tick behind" effect that interpolate_vector normally causes, but at the cost of accuracy.
 void interpolate_vector_predict(const Vector3D &before, const Vector3D &after, Vector3D &output, float scale) noexcept;
 
+/// Interpolate count floats at once. This works on any array of structs that consist entirely of floats.
+void interpolate_floats(const float *before, const float *after, float *output, size_t count, float scale) noexcept;
+
+/// Interpolate count floats at once, predicting like interpolate_vector_predict does.
+void interpolate_floats_predict(const float *before, const float *after, float *output, size_t count, float scale) noexcept;
+
+typedef void (*interpolate_floats_fn)(const float*,const float*,float*,size_t,float);
+
 /// Calculate the distance between two 2D points.
 float distance(float x1, float y1, float x2, float y2) noexcept;
 
@@ -129,8 +155,10 @@ float distance_squared(float x1, float y1, float x2, float y2) noexcept;
 /// Calculate the distance between two 3D points without taking the square root.
 float distance_squared(const Vector3D &a, const Vector3D &b) noexcept;
 
+#ifdef _WIN32
 /// Get the time elapsed since a counter.
 float counter_time_elapsed(const LARGE_INTEGER &before) noexcept;
 
 /// Get the time elapsed between two counters.
 float counter_time_elapsed(const LARGE_INTEGER &before, const LARGE_INTEGER &after) noexcept;
+#endif
@@ -0,0 +1,113 @@
+#include <cmath>
+#include "quantize.h"
+
+#define SQRT_2 1.41421356f
+
+// Find the largest component of a quaternion and return the other three normalized, in order, with signs adjusted so
+// the dropped component is positive (q and -q are the same rotation).
+static uint32_t smallest_three(const Quaternion &quaternion, float *smallest) noexcept {
+	const float *q = &quaternion.x;
+	uint32_t largest = 0;
+	for(uint32_t i = 1; i < 4; i++) {
+		if(fabs(q[i]) > fabs(q[largest])) largest = i;
+	}
+
+	float length_squared = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+	float factor = length_squared > 0 ? 1.0f / sqrt(length_squared) : 1.0f;
+	if(q[largest] < 0) factor = -factor;
+
+	for(uint32_t i = 0, s = 0; i < 4; i++) {
+		if(i != largest) smallest[s++] = q[i] * factor;
+	}
+	return largest;
+}
+
+static inline uint32_t quantize_component(float value, uint32_t max) noexcept {
+	float scaled = (value * SQRT_2 + 1.0f) * 0.5f * max + 0.5f;
+	if(scaled < 0) return 0;
+	if(scaled > max) return max;
+	return static_cast<uint32_t>(scaled);
+}
+
+static inline float dequantize_component(uint32_t value, uint32_t max) noexcept {
+	return (static_cast<float>(value) / max * 2.0f - 1.0f) / SQRT_2;
+}
+
+static void unpack_smallest_three(uint32_t largest, const float *smallest, Quaternion &output) noexcept {
+	float *q = &output.x;
+	float sum = smallest[0] * smallest[0] + smallest[1] * smallest[1] + smallest[2] * smallest[2];
+	for(uint32_t i = 0, s = 0; i < 4; i++) {
+		q[i] = i == largest ? sqrt(sum < 1.0f ? 1.0f - sum : 0.0f) : smallest[s++];
+	}
+}
+
+QuantizedQuaternion32 quantize_quat_32(const Quaternion &quaternion) noexcept {
+	float smallest[3];
+	uint32_t largest = smallest_three(quaternion, smallest);
+	return (largest << 30) | (quantize_component(smallest[0], 0x3FF) << 20) | (quantize_component(smallest[1], 0x3FF) << 10) | quantize_component(smallest[2], 0x3FF);
+}
+
+void dequantize_quat(QuantizedQuaternion32 quantized, Quaternion &output) noexcept {
+	float smallest[3] = {
+		dequantize_component((quantized >> 20) & 0x3FF, 0x3FF),
+		dequantize_component((quantized >> 10) & 0x3FF, 0x3FF),
+		dequantize_component(quantized & 0x3FF, 0x3FF)
+	};
+	unpack_smallest_three(quantized >> 30, smallest, output);
+}
+
+QuantizedQuaternion48 quantize_quat_48(const Quaternion &quaternion) noexcept {
+	float smallest[3];
+	uint32_t largest = smallest_three(quaternion, smallest);
+
+	// The index is split across the top bits of the first two words.
+	QuantizedQuaternion48 quantized;
+	quantized.data[0] = static_cast<uint16_t>(((largest & 2) << 14) | quantize_component(smallest[0], 0x7FFF));
+	quantized.data[1] = static_cast<uint16_t>(((largest & 1) << 15) | quantize_component(smallest[1], 0x7FFF));
+	quantized.data[2] = static_cast<uint16_t>(quantize_component(smallest[2], 0x7FFF));
+	return quantized;
+}
+
+void dequantize_quat(const QuantizedQuaternion48 &quantized, Quaternion &output) noexcept {
+	float smallest[3] = {
+		dequantize_component(quantized.data[0] & 0x7FFF, 0x7FFF),
+		dequantize_component(quantized.data[1] & 0x7FFF, 0x7FFF),
+		dequantize_component(quantized.data[2] & 0x7FFF, 0x7FFF)
+	};
+	uint32_t largest = ((quantized.data[0] >> 14) & 2) | (quantized.data[1] >> 15);
+	unpack_smallest_three(largest, smallest, output);
+}
+
+float quantize_position_scale(const Vector3D *positions, size_t count, const Vector3D &center, size_t stride) noexcept {
+	float max_offset = 0;
+	auto *p = reinterpret_cast<const char *>(positions);
+	for(size_t i = 0; i < count; i++) {
+		auto &position = *reinterpret_cast<const Vector3D *>(p + i * stride);
+		max_offset = fmax(max_offset, fabs(position.x - center.x));
+		max_offset = fmax(max_offset, fabs(position.y - center.y));
+		max_offset = fmax(max_offset, fabs(position.z - center.z));
+	}
+	return max_offset / 32767.0f;
+}
+
+static inline int16_t quantize_offset(float offset, float inverse_scale) noexcept {
+	float scaled = offset * inverse_scale;
+	if(scaled >= 32767.0f) return 32767;
+	if(scaled <= -32767.0f) return -32767;
+	return static_cast<int16_t>(lrintf(scaled));
+}
+
+QuantizedVector3D quantize_position(const Vector3D &position, const Vector3D &center, float scale) noexcept {
+	float inverse_scale = scale > 0 ? 1.0f / scale : 0.0f;
+	QuantizedVector3D quantized;
+	quantized.x = quantize_offset(position.x - center.x, inverse_scale);
+	quantized.y = quantize_offset(position.y - center.y, inverse_scale);
+	quantized.z = quantize_offset(position.z - center.z, inverse_scale);
+	return quantized;
+}
+
+void dequantize_position(const QuantizedVector3D &quantized, const Vector3D &center, float scale, Vector3D &output) noexcept {
+	output.x = center.x + quantized.x * scale;
+	output.y = center.y + quantized.y * scale;
+	output.z = center.z + quantized.z * scale;
+}
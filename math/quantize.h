@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include "data_types.h"
+
+// Compact formats for buffered snapshots. Quaternions use "smallest three" encoding: the largest component is dropped
+// (it can be recovered since the quaternion is normalized), and the remaining three, which all fall within
+// [-1/sqrt(2), 1/sqrt(2)], are stored as fixed point along with the index of the dropped component.
+
+/// Smallest three quaternion in 32 bits (2-bit index and three 10-bit components). Max error is ~0.002 per component.
+typedef uint32_t QuantizedQuaternion32;
+
+/// Smallest three quaternion in 48 bits (2-bit index and three 15-bit components). Max error is ~0.00006 per component.
+struct QuantizedQuaternion48 {
+    uint16_t data[3];
+};
+
+/// 3D position stored as 16-bit offsets from a center point. The scale (distance per step) is stored separately so it
+/// can be shared by every position relative to the same center.
+struct QuantizedVector3D {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+};
+
+/// Quantize a quaternion to 32 bits. It does not need to be normalized.
+QuantizedQuaternion32 quantize_quat_32(const Quaternion &quaternion) noexcept;
+
+/// Restore a 32-bit quaternion.
+void dequantize_quat(QuantizedQuaternion32 quantized, Quaternion &output) noexcept;
+
+/// Quantize a quaternion to 48 bits. It does not need to be normalized.
+QuantizedQuaternion48 quantize_quat_48(const Quaternion &quaternion) noexcept;
+
+/// Restore a 48-bit quaternion.
+void dequantize_quat(const QuantizedQuaternion48 &quantized, Quaternion &output) noexcept;
+
+/// Get the smallest position scale that can hold every one of count positions relative to center. stride is the
+/// distance in bytes between positions.
+float quantize_position_scale(const Vector3D *positions, size_t count, const Vector3D &center, size_t stride = sizeof(Vector3D)) noexcept;
+
+/// Quantize a position relative to center. The position must be within 32767 * scale of center on each axis.
+QuantizedVector3D quantize_position(const Vector3D &position, const Vector3D &center, float scale) noexcept;
+
+/// Restore a quantized position.
+void dequantize_position(const QuantizedVector3D &quantized, const Vector3D &center, float scale, Vector3D &output) noexcept;
@@ -0,0 +1,150 @@
+// Measure the error of the quantized snapshot formats and check it against the bounds documented in quantize.h, and
+// report how long encoding and decoding take.
+//
+// Usage: quantize_test
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "quantize.h"
+
+#define QUATERNION_COUNT 1000000
+#define POSITION_COUNT 64
+
+// Documented in quantize.h
+#define MAX_ERROR_32 0.002f
+#define MAX_ERROR_48 0.00006f
+
+static float random_float(float low, float high) noexcept {
+    return low + (high - low) * (static_cast<float>(rand()) / RAND_MAX);
+}
+
+// Mostly random rotations, with some near each axis (where the largest component is close to the others) and some
+// that aren't normalized.
+static void random_quaternion(size_t i, Quaternion &q) noexcept {
+    float *c = &q.x;
+    for(size_t j = 0; j < 4; j++) {
+        c[j] = random_float(-1, 1);
+    }
+    if(i % 10 == 0) {
+        c[i / 10 % 4] = 0;
+    }
+    else if(i % 10 == 1) {
+        for(size_t j = 0; j < 4; j++) {
+            c[j] = c[j] < 0 ? -0.5f : 0.5f;
+        }
+        c[i / 10 % 4] += random_float(-1.0E-4f, 1.0E-4f);
+    }
+    float length = sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    float factor = i % 10 == 2 ? 3.0f / length : 1.0f / length;
+    for(size_t j = 0; j < 4; j++) {
+        c[j] *= factor;
+    }
+}
+
+// q and -q are the same rotation, so compare against whichever sign is closer.
+static float quaternion_error(const Quaternion &input, const Quaternion &output) noexcept {
+    const float *a = &input.x;
+    const float *b = &output.x;
+    float length = sqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2] + a[3] * a[3]);
+    float same = 0, opposite = 0;
+    for(size_t j = 0; j < 4; j++) {
+        same = fmax(same, fabs(a[j] / length - b[j]));
+        opposite = fmax(opposite, fabs(a[j] / length + b[j]));
+    }
+    return fmin(same, opposite);
+}
+
+static bool check(const char *name, float error, float bound) noexcept {
+    bool ok = error <= bound;
+    printf("%-32s max error %.3g (bound %.3g) %s\n", name, error, bound, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+int main() {
+    srand(1234);
+    bool ok = true;
+
+    std::vector<Quaternion> quaternions(QUATERNION_COUNT);
+    for(size_t i = 0; i < QUATERNION_COUNT; i++) {
+        random_quaternion(i, quaternions[i]);
+    }
+
+    std::vector<QuantizedQuaternion32> quantized_32(QUATERNION_COUNT);
+    std::vector<QuantizedQuaternion48> quantized_48(QUATERNION_COUNT);
+    std::vector<Quaternion> output(QUATERNION_COUNT);
+
+    auto start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < QUATERNION_COUNT; i++) {
+        quantized_32[i] = quantize_quat_32(quaternions[i]);
+    }
+    auto encoded = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < QUATERNION_COUNT; i++) {
+        dequantize_quat(quantized_32[i], output[i]);
+    }
+    auto decoded = std::chrono::steady_clock::now();
+    double encode_32 = std::chrono::duration<double, std::nano>(encoded - start).count() / QUATERNION_COUNT;
+    double decode_32 = std::chrono::duration<double, std::nano>(decoded - encoded).count() / QUATERNION_COUNT;
+
+    float error_32 = 0;
+    for(size_t i = 0; i < QUATERNION_COUNT; i++) {
+        error_32 = fmax(error_32, quaternion_error(quaternions[i], output[i]));
+    }
+
+    start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < QUATERNION_COUNT; i++) {
+        quantized_48[i] = quantize_quat_48(quaternions[i]);
+    }
+    encoded = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < QUATERNION_COUNT; i++) {
+        dequantize_quat(quantized_48[i], output[i]);
+    }
+    decoded = std::chrono::steady_clock::now();
+    double encode_48 = std::chrono::duration<double, std::nano>(encoded - start).count() / QUATERNION_COUNT;
+    double decode_48 = std::chrono::duration<double, std::nano>(decoded - encoded).count() / QUATERNION_COUNT;
+
+    float error_48 = 0;
+    for(size_t i = 0; i < QUATERNION_COUNT; i++) {
+        error_48 = fmax(error_48, quaternion_error(quaternions[i], output[i]));
+    }
+
+    ok &= check("32-bit quaternion", error_32, MAX_ERROR_32);
+    ok &= check("48-bit quaternion", error_48, MAX_ERROR_48);
+
+    // Positions are grouped like the nodes of one object: within a few units of the center, with the center itself
+    // anywhere on the map. The error should never be more than half a step, plus float rounding of the coordinates.
+    float worst_position = 0;
+    float worst_bound = 0;
+    bool positions_ok = true;
+    for(size_t object = 0; object < 10000; object++) {
+        Vector3D center = { random_float(-500, 500), random_float(-500, 500), random_float(-100, 100) };
+        float size = object % 100 == 0 ? 0.0f : random_float(0.01f, 20);
+        Vector3D positions[POSITION_COUNT];
+        for(auto &position : positions) {
+            position = Vector3D { center.x + random_float(-size, size), center.y + random_float(-size, size), center.z + random_float(-size, size) };
+        }
+
+        float scale = quantize_position_scale(positions, POSITION_COUNT, center);
+        float magnitude = fmax(fmax(fabs(center.x), fabs(center.y)), fabs(center.z)) + size;
+        float bound = scale * 0.5f + magnitude * 2.0E-7f;
+        for(auto &position : positions) {
+            Vector3D restored;
+            dequantize_position(quantize_position(position, center, scale), center, scale, restored);
+            float error = fmax(fmax(fabs(restored.x - position.x), fabs(restored.y - position.y)), fabs(restored.z - position.z));
+            if(error > bound) positions_ok = false;
+            if(error > worst_position) {
+                worst_position = error;
+                worst_bound = bound;
+            }
+        }
+    }
+    printf("%-32s max error %.3g (bound %.3g for that object) %s\n", "16-bit position", worst_position, worst_bound, positions_ok ? "ok" : "FAILED");
+    ok &= positions_ok;
+
+    printf("32-bit quaternion: %.1f ns to encode, %.1f ns to decode\n", encode_32, decode_32);
+    printf("48-bit quaternion: %.1f ns to encode, %.1f ns to decode\n", encode_48, decode_48);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <cmath>
+#include "spatial_grid.h"
+
+// Marks the end of a bucket's list
+#define NO_POINT 0xFFFFFFFF
+
+// Looking in a cell costs about as much as checking this many points, between hashing it and walking its bucket.
+#define CELL_COST 4
+
+SpatialGrid::SpatialGrid(float cell_size, size_t bucket_count) noexcept : cell_size(cell_size), cell_scale(1.0f / cell_size) {
+	size_t count = 1;
+	while(count < bucket_count) count <<= 1;
+	this->buckets.assign(count, NO_POINT);
+}
+
+int32_t SpatialGrid::cell_coordinate(float value) const noexcept {
+	float cell = floor(value * this->cell_scale);
+	if(!(cell > -1.0E9f)) return -1000000000;
+	if(cell > 1.0E9f) return 1000000000;
+	return static_cast<int32_t>(cell);
+}
+
+uint32_t SpatialGrid::bucket_of(const int32_t cell[3]) const noexcept {
+	uint32_t hash = static_cast<uint32_t>(cell[0]) * 73856093u ^ static_cast<uint32_t>(cell[1]) * 19349663u ^ static_cast<uint32_t>(cell[2]) * 83492791u;
+	return hash & static_cast<uint32_t>(this->buckets.size() - 1);
+}
+
+void SpatialGrid::unlink(Point &point) noexcept {
+	if(point.previous != NO_POINT) this->points[point.previous].next = point.next;
+	else this->buckets[point.bucket] = point.next;
+	if(point.next != NO_POINT) this->points[point.next].previous = point.previous;
+}
+
+void SpatialGrid::insert(uint32_t key, const Vector3D &position) noexcept {
+	if(key >= this->points.size()) {
+		Point empty = {};
+		empty.in_grid = false;
+		this->points.resize(key + 1, empty);
+	}
+
+	auto &point = this->points[key];
+	int32_t cell[3] = { this->cell_coordinate(position.x), this->cell_coordinate(position.y), this->cell_coordinate(position.z) };
+
+	// Points that stay in the same cell don't need to be relinked.
+	if(point.in_grid) {
+		this->positions[point.slot] = position;
+		if(cell[0] == point.cell[0] && cell[1] == point.cell[1] && cell[2] == point.cell[2]) return;
+		this->unlink(point);
+	}
+	else {
+		point.slot = static_cast<uint32_t>(this->positions.size());
+		this->positions.push_back(position);
+		this->keys.push_back(key);
+		point.in_grid = true;
+	}
+
+	point.cell[0] = cell[0];
+	point.cell[1] = cell[1];
+	point.cell[2] = cell[2];
+	point.bucket = this->bucket_of(cell);
+	point.previous = NO_POINT;
+	point.next = this->buckets[point.bucket];
+	if(point.next != NO_POINT) this->points[point.next].previous = key;
+	this->buckets[point.bucket] = key;
+}
+
+void SpatialGrid::remove(uint32_t key) noexcept {
+	if(!this->contains(key)) return;
+	auto &point = this->points[key];
+	this->unlink(point);
+	point.in_grid = false;
+
+	// Move the last position into the hole so the positions stay packed.
+	uint32_t last = this->keys.back();
+	this->positions[point.slot] = this->positions.back();
+	this->keys[point.slot] = last;
+	this->points[last].slot = point.slot;
+	this->positions.pop_back();
+	this->keys.pop_back();
+}
+
+void SpatialGrid::clear() noexcept {
+	std::fill(this->buckets.begin(), this->buckets.end(), NO_POINT);
+	this->points.clear();
+	this->positions.clear();
+	this->keys.clear();
+}
+
+bool SpatialGrid::contains(uint32_t key) const noexcept {
+	return key < this->points.size() && this->points[key].in_grid;
+}
+
+size_t SpatialGrid::size() const noexcept {
+	return this->positions.size();
+}
+
+template<typename F> void SpatialGrid::for_each_in_radius(const Vector3D &center, float radius, F add) const noexcept {
+	if(this->positions.size() == 0 || !(radius >= 0)) return;
+	float radius_squared = radius * radius;
+
+	int32_t low[3] = { this->cell_coordinate(center.x - radius), this->cell_coordinate(center.y - radius), this->cell_coordinate(center.z - radius) };
+	int32_t high[3] = { this->cell_coordinate(center.x + radius), this->cell_coordinate(center.y + radius), this->cell_coordinate(center.z + radius) };
+	double cell_count = 1.0;
+	for(size_t i = 0; i < 3; i++) {
+		cell_count *= static_cast<double>(high[i]) - low[i] + 1;
+	}
+
+	// If looking in every cell would cost more than checking every point, just check every point.
+	if(cell_count * CELL_COST > this->positions.size()) {
+		for(size_t slot = 0; slot < this->positions.size(); slot++) {
+			float d = distance_squared(center, this->positions[slot]);
+			if(d <= radius_squared) add(this->keys[slot], d);
+		}
+		return;
+	}
+
+	for(int32_t x = low[0]; x <= high[0]; x++) {
+		for(int32_t y = low[1]; y <= high[1]; y++) {
+			for(int32_t z = low[2]; z <= high[2]; z++) {
+				int32_t cell[3] = { x, y, z };
+				for(uint32_t key = this->buckets[this->bucket_of(cell)]; key != NO_POINT; key = this->points[key].next) {
+					// Other cells can hash to the same bucket. Skip them, or they'd be found more than once.
+					auto &point = this->points[key];
+					if(point.cell[0] != x || point.cell[1] != y || point.cell[2] != z) continue;
+					float d = distance_squared(center, this->positions[point.slot]);
+					if(d <= radius_squared) add(key, d);
+				}
+			}
+		}
+	}
+}
+
+void SpatialGrid::find_in_radius(const Vector3D &center, float radius, std::vector<uint32_t> &output) const noexcept {
+	this->for_each_in_radius(center, radius, [&output](uint32_t key, float) {
+		output.push_back(key);
+	});
+}
+
+void SpatialGrid::find_nearest(const Vector3D &center, size_t count, std::vector<uint32_t> &output, float max_radius) const noexcept {
+	if(count == 0) return;
+
+	struct Candidate {
+		uint32_t key;
+		float distance_squared;
+
+		bool operator<(const Candidate &other) const noexcept {
+			return this->distance_squared < other.distance_squared;
+		}
+	};
+
+	// Only the nearest count points found so far are kept. Once there are that many, they're a max-heap so the furthest
+	// one can be replaced, and anything further away than it is rejected with one comparison.
+	std::vector<Candidate> candidates;
+	candidates.reserve(count < this->positions.size() ? count : this->positions.size());
+	float furthest;
+	auto add = [&candidates, &furthest, count](uint32_t key, float d) {
+		if(d >= furthest) return;
+		if(candidates.size() < count) {
+			candidates.push_back(Candidate { key, d });
+			if(candidates.size() < count) return;
+			std::make_heap(candidates.begin(), candidates.end());
+		}
+		else {
+			std::pop_heap(candidates.begin(), candidates.end());
+			candidates.back() = Candidate { key, d };
+			std::push_heap(candidates.begin(), candidates.end());
+		}
+		furthest = candidates.front().distance_squared;
+	};
+
+	// Every point within the radius is found, so once there are enough of them, the nearest ones must be among them.
+	// Otherwise, double the radius and try again.
+	float radius = this->cell_size;
+	while(true) {
+		if(radius > max_radius) radius = max_radius;
+		candidates.clear();
+		furthest = INFINITY;
+		this->for_each_in_radius(center, radius, add);
+		if(candidates.size() == count || candidates.size() == this->positions.size() || radius >= max_radius) break;
+
+		// Once every point would be checked anyway, there's no point in growing the radius gradually.
+		double cells = pow(2.0 * radius * 2.0 * this->cell_scale + 1.0, 3.0);
+		radius = cells * CELL_COST > this->positions.size() ? max_radius : radius * 2.0f;
+	}
+
+	std::sort(candidates.begin(), candidates.end());
+	for(auto &candidate : candidates) {
+		output.push_back(candidate.key);
+	}
+}
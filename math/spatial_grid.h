@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "data_types.h"
+
+/// This is a uniform grid of points for proximity queries. Space is split into cubes of cell_size, and cells are hashed
+/// into a fixed number of buckets, so the grid covers any amount of space without knowing its bounds.
+///
+/// Points are identified by a small integer key (such as an object's table index). Keys index an array, so they should
+/// be dense. Inserting, moving and removing a point is O(1).
+class SpatialGrid {
+public:
+    /// Make a grid with cells of cell_size units. bucket_count is rounded up to a power of two.
+    SpatialGrid(float cell_size = 8.0f, size_t bucket_count = 4096) noexcept;
+
+    /// Add a point, or move it if it's already in the grid.
+    void insert(uint32_t key, const Vector3D &position) noexcept;
+
+    /// Remove a point if it's in the grid.
+    void remove(uint32_t key) noexcept;
+
+    /// Remove every point.
+    void clear() noexcept;
+
+    /// Return true if key is in the grid.
+    bool contains(uint32_t key) const noexcept;
+
+    /// Get the number of points in the grid.
+    size_t size() const noexcept;
+
+    /// Append the key of every point within radius of center to output, in no particular order.
+    void find_in_radius(const Vector3D &center, float radius, std::vector<uint32_t> &output) const noexcept;
+
+    /// Append the keys of the count points nearest to center to output, nearest first. Points further than max_radius
+    /// away are ignored.
+    void find_nearest(const Vector3D &center, size_t count, std::vector<uint32_t> &output, float max_radius = 1.0E30f) const noexcept;
+
+private:
+    struct Point {
+        int32_t cell[3];
+        uint32_t bucket;
+        /// Next and previous keys in the same bucket, or 0xFFFFFFFF if there isn't one
+        uint32_t next;
+        uint32_t previous;
+        /// Index of the point's position in positions
+        uint32_t slot;
+        bool in_grid;
+    };
+
+    float cell_size;
+    float cell_scale;
+    std::vector<uint32_t> buckets;
+    std::vector<Point> points;
+    /// Positions of the points in the grid, packed together so checking every point reads as little as possible
+    std::vector<Vector3D> positions;
+    /// Key of each position
+    std::vector<uint32_t> keys;
+
+    int32_t cell_coordinate(float value) const noexcept;
+    uint32_t bucket_of(const int32_t cell[3]) const noexcept;
+    void unlink(Point &point) noexcept;
+
+    /// Call add for each point within radius of center with its squared distance.
+    template<typename F> void for_each_in_radius(const Vector3D &center, float radius, F add) const noexcept;
+};
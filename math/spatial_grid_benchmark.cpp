@@ -0,0 +1,150 @@
+// Time SpatialGrid updates and queries on synthetic point clouds, next to the brute force scans they replace.
+//
+// Usage: spatial_grid_benchmark [-n iterations]
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "spatial_grid.h"
+
+// About as many objects as there are in a busy game
+#define POINT_COUNT 2048
+
+// Queries per iteration
+#define QUERY_COUNT 256
+
+static float random_float(float low, float high) noexcept {
+    return low + (high - low) * (static_cast<float>(rand()) / RAND_MAX);
+}
+
+struct Cloud {
+    const char *name;
+    std::vector<Vector3D> points;
+};
+
+// Spread across a large multiplayer map, or bunched up around a few bases
+static void make_clouds(std::vector<Cloud> &clouds) noexcept {
+    clouds.push_back(Cloud { "uniform", {} });
+    clouds.push_back(Cloud { "clustered", {} });
+    static const Vector3D centers[] = { { -80, 20, 5 }, { 80, -20, 5 }, { 0, 0, -2 } };
+    for(size_t i = 0; i < POINT_COUNT; i++) {
+        clouds[0].points.push_back(Vector3D { random_float(-200, 200), random_float(-200, 200), random_float(-50, 50) });
+        auto &center = centers[rand() % 3];
+        clouds[1].points.push_back(Vector3D { center.x + random_float(-10, 10), center.y + random_float(-10, 10), center.z + random_float(-2, 2) });
+    }
+}
+
+template<typename F>
+static double time_function(int iterations, size_t operations, F function) noexcept {
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++) {
+        function();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations / operations;
+}
+
+int main(int argc, const char **argv) {
+    int iterations = 200;
+    if(argc == 3 && strcmp(argv[1], "-n") == 0) {
+        iterations = atoi(argv[2]);
+    }
+    if((argc != 1 && argc != 3) || iterations <= 0) {
+        fprintf(stderr, "Usage: %s [-n iterations]\n", argv[0]);
+        return 1;
+    }
+
+    srand(5678);
+    std::vector<Cloud> clouds;
+    make_clouds(clouds);
+
+    printf("%-28s%12s%12s\n", "ns per operation", "grid", "brute force");
+    for(auto &cloud : clouds) {
+        printf("%s (%d points):\n", cloud.name, POINT_COUNT);
+        auto &points = cloud.points;
+        SpatialGrid grid;
+        for(uint32_t key = 0; key < POINT_COUNT; key++) {
+            grid.insert(key, points[key]);
+        }
+
+        // Moving every point a little each tick, which is what the object grid does
+        std::vector<Vector3D> moved = points;
+        for(auto &point : moved) {
+            point.x += 0.05f;
+        }
+        double update = time_function(iterations, POINT_COUNT * 2, [&]() {
+            for(uint32_t key = 0; key < POINT_COUNT; key++) {
+                grid.insert(key, moved[key]);
+            }
+            for(uint32_t key = 0; key < POINT_COUNT; key++) {
+                grid.insert(key, points[key]);
+            }
+        });
+        printf("    %-24s%12.1f%12s\n", "insert (move)", update, "-");
+
+        std::vector<Vector3D> centers;
+        for(size_t q = 0; q < QUERY_COUNT; q++) {
+            centers.push_back(points[rand() % POINT_COUNT]);
+        }
+
+        std::vector<uint32_t> found;
+        size_t sink = 0;
+        static const float radii[] = { 2.0f, 10.0f, 50.0f };
+        for(float radius : radii) {
+            double grid_time = time_function(iterations, QUERY_COUNT, [&]() {
+                for(auto &center : centers) {
+                    found.clear();
+                    grid.find_in_radius(center, radius, found);
+                    sink += found.size();
+                }
+            });
+            double brute_time = time_function(iterations, QUERY_COUNT, [&]() {
+                for(auto &center : centers) {
+                    found.clear();
+                    for(uint32_t key = 0; key < POINT_COUNT; key++) {
+                        if(distance_squared(center, points[key]) <= radius * radius) found.push_back(key);
+                    }
+                    sink += found.size();
+                }
+            });
+            char name[32];
+            snprintf(name, sizeof(name), "find_in_radius (%g)", radius);
+            printf("    %-24s%12.1f%12.1f\n", name, grid_time, brute_time);
+        }
+
+        static const size_t counts[] = { 1, 8 };
+        for(size_t count : counts) {
+            double grid_time = time_function(iterations, QUERY_COUNT, [&]() {
+                for(auto &center : centers) {
+                    found.clear();
+                    grid.find_nearest(center, count, found);
+                    sink += found.size();
+                }
+            });
+            std::vector<std::pair<float, uint32_t>> candidates;
+            double brute_time = time_function(iterations, QUERY_COUNT, [&]() {
+                for(auto &center : centers) {
+                    found.clear();
+                    candidates.clear();
+                    for(uint32_t key = 0; key < POINT_COUNT; key++) {
+                        candidates.emplace_back(distance_squared(center, points[key]), key);
+                    }
+                    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+                    for(size_t i = 0; i < count; i++) {
+                        found.push_back(candidates[i].second);
+                    }
+                    sink += found.size();
+                }
+            });
+            char name[32];
+            snprintf(name, sizeof(name), "find_nearest (%zu)", count);
+            printf("    %-24s%12.1f%12.1f\n", name, grid_time, brute_time);
+        }
+
+        // Keep the results alive so none of the queries can be optimized out.
+        if(sink == 0) printf("    (nothing found)\n");
+    }
+    return 0;
+}
@@ -0,0 +1,157 @@
+// Check SpatialGrid against brute force on synthetic point clouds while points are added, moved and removed.
+//
+// Usage: spatial_grid_test
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "spatial_grid.h"
+
+// About as many objects as the object table holds
+#define KEY_COUNT 2048
+
+static float random_float(float low, float high) noexcept {
+    return low + (high - low) * (static_cast<float>(rand()) / RAND_MAX);
+}
+
+/// A cloud of points in some shape, along with what the grid should contain.
+struct Cloud {
+    const char *name;
+    Vector3D (*random_point)();
+    float cell_size;
+};
+
+static const Cloud clouds[] = {
+    // Spread across a large multiplayer map
+    { "uniform", []() { return Vector3D { random_float(-200, 200), random_float(-200, 200), random_float(-50, 50) }; }, 8.0f },
+
+    // Bunched up in a few places, like objects around bases and spawns
+    { "clustered", []() {
+        static const Vector3D centers[] = { { -80, 20, 5 }, { 80, -20, 5 }, { 0, 0, -2 } };
+        auto &center = centers[rand() % 3];
+        return Vector3D { center.x + random_float(-3, 3), center.y + random_float(-3, 3), center.z + random_float(-1, 1) };
+    }, 8.0f },
+
+    // Exactly on cell boundaries, where rounding decides which cell a point is in
+    { "cell boundaries", []() { return Vector3D { (rand() % 21 - 10) * 4.0f, (rand() % 21 - 10) * 4.0f, (rand() % 5 - 2) * 4.0f }; }, 4.0f },
+
+    // Far enough out that cell coordinates get clamped
+    { "huge coordinates", []() { return Vector3D { random_float(-1.0E12f, 1.0E12f), random_float(-10, 10), random_float(-10, 10) }; }, 1.0f },
+
+    // Small cells so most queries cover more cells than there are points
+    { "tiny cells", []() { return Vector3D { random_float(-20, 20), random_float(-20, 20), random_float(-20, 20) }; }, 0.25f }
+};
+
+static size_t failures = 0;
+
+static void fail(const Cloud &cloud, const char *what) noexcept {
+    if(failures < 20) fprintf(stderr, "    %s: %s\n", cloud.name, what);
+    failures++;
+}
+
+static Vector3D random_center(const Cloud &cloud, const std::vector<Vector3D> &positions, const std::vector<bool> &present) noexcept {
+    // Half of the queries are centered on a point in the grid, since that's how they're usually made.
+    if(rand() % 2) {
+        uint32_t key = rand() % KEY_COUNT;
+        if(present[key]) return positions[key];
+    }
+    return cloud.random_point();
+}
+
+static void check_queries(const Cloud &cloud, const SpatialGrid &grid, const std::vector<Vector3D> &positions, const std::vector<bool> &present) noexcept {
+    auto center = random_center(cloud, positions, present);
+    static const float radii[] = { 0.0f, 0.5f, 2.0f, 10.0f, 75.0f, 1.0E13f };
+    float radius = radii[rand() % (sizeof(radii) / sizeof(*radii))];
+
+    // Everything within the radius, compared as sorted sets
+    std::vector<uint32_t> expected;
+    for(uint32_t key = 0; key < KEY_COUNT; key++) {
+        if(present[key] && distance_squared(center, positions[key]) <= radius * radius) expected.push_back(key);
+    }
+    std::vector<uint32_t> found;
+    grid.find_in_radius(center, radius, found);
+    std::sort(found.begin(), found.end());
+    if(found != expected) fail(cloud, "find_in_radius() doesn't match brute force");
+
+    // Nearest points. Points the same distance away can come in either order, so compare distances rather than keys.
+    size_t count = 1 + rand() % 16;
+    float max_radius = rand() % 2 ? radius : 1.0E30f;
+    std::vector<float> expected_distances;
+    for(uint32_t key = 0; key < KEY_COUNT; key++) {
+        float d = distance_squared(center, positions[key]);
+        if(present[key] && d <= max_radius * max_radius) expected_distances.push_back(d);
+    }
+    std::sort(expected_distances.begin(), expected_distances.end());
+    if(expected_distances.size() > count) expected_distances.resize(count);
+
+    std::vector<uint32_t> nearest;
+    grid.find_nearest(center, count, nearest, max_radius);
+    std::vector<float> nearest_distances;
+    for(auto key : nearest) {
+        if(key >= KEY_COUNT || !present[key]) {
+            fail(cloud, "find_nearest() found a point that isn't in the grid");
+            return;
+        }
+        nearest_distances.push_back(distance_squared(center, positions[key]));
+    }
+    if(nearest_distances != expected_distances) fail(cloud, "find_nearest() doesn't match brute force");
+}
+
+static void check_cloud(const Cloud &cloud) noexcept {
+    SpatialGrid grid(cloud.cell_size, 256);
+    std::vector<Vector3D> positions(KEY_COUNT);
+    std::vector<bool> present(KEY_COUNT, false);
+    size_t present_count = 0;
+
+    for(size_t step = 0; step < 20000; step++) {
+        uint32_t key = rand() % KEY_COUNT;
+        int action = rand() % 10;
+        if(action < 5) {
+            // Add or teleport
+            positions[key] = cloud.random_point();
+            grid.insert(key, positions[key]);
+            present_count += !present[key];
+            present[key] = true;
+        }
+        else if(action < 8) {
+            // Nudge, which usually stays in the same cell
+            if(!present[key]) continue;
+            positions[key].x += random_float(-0.5f, 0.5f);
+            positions[key].y += random_float(-0.5f, 0.5f);
+            grid.insert(key, positions[key]);
+        }
+        else {
+            grid.remove(key);
+            present_count -= present[key];
+            present[key] = false;
+        }
+
+        if(grid.size() != present_count || grid.contains(key) != present[key]) {
+            fail(cloud, "size() or contains() is wrong");
+            return;
+        }
+        if(step % 20 == 0) check_queries(cloud, grid, positions, present);
+    }
+
+    grid.clear();
+    std::vector<uint32_t> found;
+    grid.find_in_radius(Vector3D { 0, 0, 0 }, 1.0E13f, found);
+    if(grid.size() != 0 || !found.empty()) fail(cloud, "clear() left points in the grid");
+}
+
+int main() {
+    srand(5678);
+    for(auto &cloud : clouds) {
+        size_t failures_before = failures;
+        check_cloud(cloud);
+        printf("    %-24s %s\n", cloud.name, failures == failures_before ? "ok" : "FAILED");
+    }
+
+    if(failures) {
+        printf("%zu checks failed\n", failures);
+        return 1;
+    }
+    return 0;
+}